@@ -0,0 +1,94 @@
+// AVL order statistics vs sort-and-index.
+//
+// Static phase: with n random keys loaded, times order_of_key (rank), find_by_order
+// (select), count_range and percentile on the AVL tree against the same queries on a
+// sorted vector (lower_bound / indexing).
+// Dynamic phase: interleaves inserts with p99 queries, where the sorted vector has to
+// shift its tail on every insert while the AVL tree stays O(log n).
+//
+//   avl_order_stats_bench [--ops 1e7] [--queries 1e6] [--updates 1e3] [--seed 42]
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "../src/avl_tree.h"
+
+using namespace std;
+
+template <typename F>
+static double nsPerOp(size_t ops, F f) {
+    uint64_t start = bench::nowNs();
+    for (size_t i = 0; i < ops; i++) f(i);
+    return (double)(bench::nowNs() - start) / ops;
+}
+
+static int sortedPercentile(const vector<int>& sorted, double p) {
+    int n = (int)sorted.size();
+    int rank = min(max((int)ceil(p / 100.0 * n), 1), n);
+    return sorted[rank - 1];
+}
+
+int main(int argc, char** argv) {
+    size_t n = (size_t)stod(bench::argValue(argc, argv, "--ops", "1e7"));
+    size_t queries = (size_t)stod(bench::argValue(argc, argv, "--queries", "1e6"));
+    size_t updates = (size_t)stod(bench::argValue(argc, argv, "--updates", "1e3"));
+    uint64_t seed = stoull(bench::argValue(argc, argv, "--seed", "42"));
+
+    vector<int> keys = bench::makeKeys("random", n, seed);
+    vector<int> probes = bench::makeKeys("random", queries, seed + 1);
+
+    NodePool<avl::AVLNode> pool;
+    avl::AVLNode* root = nullptr;
+    uint64_t start = bench::nowNs();
+    for (int k : keys) root = avl::insert(root, k, &pool);
+    double avlBuildMs = (bench::nowNs() - start) / 1e6;
+
+    start = bench::nowNs();
+    vector<int> sorted = keys;
+    sort(sorted.begin(), sorted.end());
+    sorted.erase(unique(sorted.begin(), sorted.end()), sorted.end());
+    double sortMs = (bench::nowNs() - start) / 1e6;
+
+    int size = avl::getSize(root);
+    printf("%zu keys (%d distinct): AVL build %.0f ms, sort %.0f ms\n\n", n, size, avlBuildMs, sortMs);
+    printf("%-14s %12s %12s\n", "query", "avl ns/op", "sorted ns/op");
+
+    long long sink = 0;
+    double a = nsPerOp(queries, [&](size_t i) { sink += avl::order_of_key(root, probes[i]); });
+    double s = nsPerOp(queries, [&](size_t i) { sink += lower_bound(sorted.begin(), sorted.end(), probes[i]) - sorted.begin(); });
+    printf("%-14s %12.1f %12.1f\n", "rank", a, s);
+
+    a = nsPerOp(queries, [&](size_t i) { sink += avl::find_by_order(root, (int)(probes[i] % size))->data; });
+    s = nsPerOp(queries, [&](size_t i) { sink += sorted[probes[i] % size]; });
+    printf("%-14s %12.1f %12.1f\n", "select", a, s);
+
+    a = nsPerOp(queries, [&](size_t i) { sink += avl::count_range(root, probes[i] / 2, probes[i]); });
+    s = nsPerOp(queries, [&](size_t i) {
+        sink += upper_bound(sorted.begin(), sorted.end(), probes[i]) - lower_bound(sorted.begin(), sorted.end(), probes[i] / 2);
+    });
+    printf("%-14s %12.1f %12.1f\n", "count_range", a, s);
+
+    a = nsPerOp(queries, [&](size_t i) { sink += avl::percentile(root, (i % 1000) / 10.0 + 0.1)->data; });
+    s = nsPerOp(queries, [&](size_t i) { sink += sortedPercentile(sorted, (i % 1000) / 10.0 + 0.1); });
+    printf("%-14s %12.1f %12.1f\n", "percentile", a, s);
+
+    // Each update inserts one new key and then asks for the p99
+    vector<int> fresh = bench::makeKeys("random", updates, seed + 2);
+    a = nsPerOp(updates, [&](size_t i) {
+        root = avl::insert(root, fresh[i], &pool);
+        sink += avl::percentile(root, 99)->data;
+    });
+    s = nsPerOp(updates, [&](size_t i) {
+        auto it = lower_bound(sorted.begin(), sorted.end(), fresh[i]);
+        if (it == sorted.end() || *it != fresh[i]) sorted.insert(it, fresh[i]);
+        sink += sortedPercentile(sorted, 99);
+    });
+    printf("%-14s %12.1f %12.1f\n", "insert+p99", a, s);
+
+    bench::doNotOptimize(sink);
+    return 0;
+}
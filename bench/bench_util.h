@@ -0,0 +1,189 @@
+#ifndef BENCH_UTIL_H
+#define BENCH_UTIL_H
+
+// Small helpers shared by the benchmark drivers: clocks, latency histograms,
+// peak RSS, workload key generators and command-line parsing.
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+namespace bench {
+
+inline uint64_t nowNs() {
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+// Log-linear latency histogram: 16 sub-buckets per power of two, so percentiles
+// are accurate to about 6% with fixed memory regardless of the number of samples.
+struct LatencyHistogram {
+    static const int SUB = 16;
+    std::vector<uint64_t> buckets = std::vector<uint64_t>(64 * SUB, 0);
+    uint64_t count = 0;
+    uint64_t maxNs = 0;
+
+    static int bucketOf(uint64_t ns) {
+        if (ns < SUB) return (int)ns;
+        int msb = 63 - __builtin_clzll(ns);
+        int sub = (int)((ns >> (msb - 4)) & (SUB - 1));
+        return (msb - 3) * SUB + sub;
+    }
+
+    static uint64_t bucketLow(int b) {
+        if (b < SUB) return b;
+        int msb = b / SUB + 3;
+        return ((uint64_t)(SUB + b % SUB)) << (msb - 4);
+    }
+
+    void record(uint64_t ns) {
+        buckets[bucketOf(ns)]++;
+        count++;
+        if (ns > maxNs) maxNs = ns;
+    }
+
+    void merge(const LatencyHistogram& other) {
+        for (size_t b = 0; b < buckets.size(); b++) buckets[b] += other.buckets[b];
+        count += other.count;
+        maxNs = std::max(maxNs, other.maxNs);
+    }
+
+    uint64_t percentile(double p) const {
+        if (count == 0) return 0;
+        uint64_t target = (uint64_t)std::ceil(p / 100.0 * count);
+        if (target == 0) target = 1;
+        uint64_t seen = 0;
+        for (size_t b = 0; b < buckets.size(); b++) {
+            seen += buckets[b];
+            if (seen >= target) return bucketLow((int)b);
+        }
+        return maxNs;
+    }
+};
+
+// Peak resident set size of this process in KiB (0 where unsupported)
+inline long peakRssKiB() {
+#if defined(__unix__) || defined(__APPLE__)
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+#if defined(__APPLE__)
+    return ru.ru_maxrss / 1024;
+#else
+    return ru.ru_maxrss;
+#endif
+#else
+    return 0;
+#endif
+}
+
+// Zipfian generator over [0, n) (Gray et al., "Quickly generating billion-record
+// synthetic databases"); O(n) setup, O(1) per sample.
+class ZipfianGenerator {
+public:
+    ZipfianGenerator(uint64_t n, double theta, uint64_t seed) : n(n), theta(theta), rng(seed) {
+        zetan = zeta(n, theta);
+        double zeta2 = zeta(2, theta);
+        alpha = 1.0 / (1.0 - theta);
+        eta = (1 - std::pow(2.0 / n, 1 - theta)) / (1 - zeta2 / zetan);
+    }
+
+    uint64_t next() {
+        double u = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+        double uz = u * zetan;
+        if (uz < 1.0) return 0;
+        if (uz < 1.0 + std::pow(0.5, theta)) return 1;
+        uint64_t v = (uint64_t)(n * std::pow(eta * u - eta + 1, alpha));
+        return std::min(v, n - 1);
+    }
+
+private:
+    static double zeta(uint64_t n, double theta) {
+        double sum = 0;
+        for (uint64_t i = 1; i <= n; i++) sum += 1.0 / std::pow((double)i, theta);
+        return sum;
+    }
+
+    uint64_t n;
+    double theta, zetan, alpha, eta;
+    std::mt19937_64 rng;
+};
+
+// Generate n keys for the named workload: "sequential", "random" or "zipfian"
+inline std::vector<int> makeKeys(const std::string& workload, size_t n, uint64_t seed) {
+    std::vector<int> keys(n);
+    if (workload == "sequential") {
+        for (size_t i = 0; i < n; i++) keys[i] = (int)i;
+    } else if (workload == "random") {
+        std::mt19937_64 rng(seed);
+        std::uniform_int_distribution<int> dist(0, INT_MAX);
+        for (size_t i = 0; i < n; i++) keys[i] = dist(rng);
+    } else if (workload == "zipfian") {
+        // Hot ranks are scattered over the key space so popular keys are not all adjacent
+        ZipfianGenerator zipf(n, 0.99, seed);
+        for (size_t i = 0; i < n; i++) keys[i] = (int)((zipf.next() * 2654435761u) % INT_MAX);
+    } else {
+        std::fprintf(stderr, "unknown workload '%s'\n", workload.c_str());
+        std::exit(2);
+    }
+    return keys;
+}
+
+// Parse "1000,1e5,10000000" into a list of sizes
+inline std::vector<size_t> parseSizes(const std::string& s) {
+    std::vector<size_t> out;
+    size_t start = 0;
+    while (start < s.size()) {
+        size_t comma = s.find(',', start);
+        if (comma == std::string::npos) comma = s.size();
+        out.push_back((size_t)std::stod(s.substr(start, comma - start)));
+        start = comma + 1;
+    }
+    return out;
+}
+
+// Split "a,b,c" into its parts
+inline std::vector<std::string> parseList(const std::string& s) {
+    std::vector<std::string> out;
+    size_t start = 0;
+    while (start < s.size()) {
+        size_t comma = s.find(',', start);
+        if (comma == std::string::npos) comma = s.size();
+        out.push_back(s.substr(start, comma - start));
+        start = comma + 1;
+    }
+    return out;
+}
+
+// Value of "--name value" in argv, or fallback when absent
+inline std::string argValue(int argc, char** argv, const std::string& name, const std::string& fallback) {
+    for (int i = 1; i + 1 < argc; i++)
+        if (name == argv[i]) return argv[i + 1];
+    return fallback;
+}
+
+inline bool hasFlag(int argc, char** argv, const std::string& name) {
+    for (int i = 1; i < argc; i++)
+        if (name == argv[i]) return true;
+    return false;
+}
+
+// Keeps the optimizer from discarding benchmark results
+template <typename T>
+inline void doNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+}  // namespace bench
+
+#endif
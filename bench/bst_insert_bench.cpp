@@ -0,0 +1,41 @@
+// BST insert scaling benchmark.
+//
+// Loads n random keys into the BST for each requested size and reports the mean
+// cost per insert, normalised by log2(n). With subtree sizes maintained along the
+// insert path the normalised column stays roughly flat as n grows.
+//
+//   bst_insert_bench [--ops 1e3,1e4,1e5,1e6,1e7] [--seed 42]
+
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "../src/binary_search_tree.h"
+#include "../src/node_pool.h"
+
+using namespace std;
+
+int main(int argc, char** argv) {
+    vector<size_t> sizes = bench::parseSizes(bench::argValue(argc, argv, "--ops", "1e3,1e4,1e5,1e6,1e7"));
+    uint64_t seed = stoull(bench::argValue(argc, argv, "--seed", "42"));
+
+    printf("%11s %12s %14s %8s %10s\n", "n", "ns/insert", "ns/(ins*lg n)", "height", "size ok");
+    for (size_t n : sizes) {
+        vector<int> keys = bench::makeKeys("random", n, seed);
+
+        NodePool<bst::t_node> pool;  // Frees the tree at the end of the iteration
+        bst::t_node* root = nullptr;
+        uint64_t start = bench::nowNs();
+        for (size_t i = 0; i < n; i++) root = bst::insertBST(root, keys[i], &pool);
+        uint64_t elapsed = bench::nowNs() - start;
+
+        double perInsert = (double)elapsed / n;
+        bool sizeOk = bst::countNodes(root) == (int)n;
+        printf("%11zu %12.1f %14.2f %8d %10s\n", n, perInsert, perInsert / log2((double)max<size_t>(n, 2)),
+               bst::findHeight(root), sizeOk ? "yes" : "NO");
+        fflush(stdout);
+    }
+    return 0;
+}
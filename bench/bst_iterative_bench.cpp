@@ -0,0 +1,196 @@
+// Iterative vs recursive BST operations.
+//
+// 1. Balanced case: random keys, compares the iterative search/height/leaf/diameter/
+//    inorder functions in binary_search_tree.h against the previous recursive versions.
+// 2. Degenerate case: a sorted key stream (a linked-list shaped tree) processed by the
+//    iterative versions on a thread with a deliberately small native stack.
+//
+//   bst_iterative_bench [--ops 1e6] [--sorted 1e7] [--sorted-insert 2e4] [--stack-kib 256]
+
+#include <cstdio>
+#include <iostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#include <pthread.h>
+
+#include "bench_util.h"
+#include "../src/binary_search_tree.h"
+#include "../src/node_pool.h"
+
+using namespace std;
+using bst::t_node;
+
+// The recursive implementations binary_search_tree.h used before, kept as the baseline
+namespace recursive {
+
+bool searchNode(t_node* root, int key) {
+    if (!root) return false;
+    if (root->data == key) return true;
+    if (key < root->data) return recursive::searchNode(root->left, key);
+    return recursive::searchNode(root->right, key);
+}
+
+int findHeight(t_node* root) {
+    if (!root) return 0;
+    return max(recursive::findHeight(root->left), recursive::findHeight(root->right)) + 1;
+}
+
+int countLeafNodes(t_node* root) {
+    if (!root) return 0;
+    if (!root->left && !root->right) return 1;
+    return recursive::countLeafNodes(root->left) + recursive::countLeafNodes(root->right);
+}
+
+int findDiameter(t_node* root, int& diameter) {
+    if (!root) return 0;
+    int leftHeight = recursive::findDiameter(root->left, diameter);
+    int rightHeight = recursive::findDiameter(root->right, diameter);
+    diameter = max(diameter, leftHeight + rightHeight + 1);
+    return max(leftHeight, rightHeight) + 1;
+}
+
+void Inorder(t_node* root) {
+    if (!root) return;
+    recursive::Inorder(root->left);
+    cout << root->data << " ";
+    recursive::Inorder(root->right);
+}
+
+}  // namespace recursive
+
+// Swallows traversal output so only the walk itself is timed
+struct NullBuffer : streambuf {
+    int overflow(int c) override { return c; }
+    streamsize xsputn(const char*, streamsize n) override { return n; }
+};
+
+template <typename F>
+static double timeMs(F f) {
+    uint64_t start = bench::nowNs();
+    f();
+    return (bench::nowNs() - start) / 1e6;
+}
+
+// Best of three runs, to keep cache warm-up out of the comparison
+template <typename F>
+static double bestMs(F f) {
+    double best = timeMs(f);
+    for (int run = 0; run < 2; run++) best = min(best, timeMs(f));
+    return best;
+}
+
+template <typename F>
+static double timeSilentMs(F f) {
+    NullBuffer sink;
+    streambuf* old = cout.rdbuf(&sink);
+    double ms = timeMs(f);
+    cout.rdbuf(old);
+    return ms;
+}
+
+static void row(const char* op, double recursiveMs, double iterativeMs) {
+    printf("%-10s %14.2f %14.2f %8.2fx\n", op, recursiveMs, iterativeMs, recursiveMs / iterativeMs);
+}
+
+static void balancedCase(size_t n) {
+    vector<int> keys = bench::makeKeys("random", n, 42);
+    NodePool<t_node> pool;
+    t_node* root = nullptr;
+    for (int k : keys) root = bst::insertBST(root, k, &pool);
+
+    printf("balanced: %zu random keys, height %d\n", n, bst::findHeight(root));
+    printf("%-10s %14s %14s %9s\n", "op", "recursive(ms)", "iterative(ms)", "speedup");
+
+    size_t found = 0;
+    double r = bestMs([&] { for (int k : keys) found += recursive::searchNode(root, k); });
+    double i = bestMs([&] { for (int k : keys) found += bst::searchNode(root, k); });
+    bench::doNotOptimize(found);
+    row("search", r, i);
+
+    int h = 0;
+    r = bestMs([&] { h += recursive::findHeight(root); });
+    i = bestMs([&] { h += bst::findHeight(root); });
+    bench::doNotOptimize(h);
+    row("height", r, i);
+
+    int leaves = 0;
+    r = bestMs([&] { leaves += recursive::countLeafNodes(root); });
+    i = bestMs([&] { leaves += bst::countLeafNodes(root); });
+    bench::doNotOptimize(leaves);
+    row("leaves", r, i);
+
+    int d1 = 0, d2 = 0;
+    r = bestMs([&] { recursive::findDiameter(root, d1); });
+    i = bestMs([&] { bst::findDiameter(root, d2); });
+    row("diameter", r, i);
+    if (d1 != d2) printf("diameter mismatch: %d vs %d\n", d1, d2);
+
+    r = timeSilentMs([&] { recursive::Inorder(root); });
+    i = timeSilentMs([&] { bst::Inorder(root); });
+    row("inorder", r, i);
+}
+
+struct DegenerateArgs {
+    size_t n;
+    size_t insertN;
+};
+
+static void* degenerateCase(void* p) {
+    DegenerateArgs* args = static_cast<DegenerateArgs*>(p);
+
+    // insertBST on sorted input is O(n) per insert, so only a prefix is inserted for timing
+    NodePool<t_node> pool;
+    t_node* prefix = nullptr;
+    double insertMs = timeMs([&] { for (size_t k = 0; k < args->insertN; k++) prefix = bst::insertBST(prefix, (int)k, &pool); });
+    printf("sorted insertBST x %zu: %.2f ms (height %d)\n", args->insertN, insertMs, bst::findHeight(prefix));
+
+    // Build the same right-leaning chain sorted insertion produces, directly in O(n)
+    size_t n = args->n;
+    t_node* root = newNode(&pool, 0);
+    t_node* tail = root;
+    for (size_t k = 1; k < n; k++) {
+        tail->right = newNode(&pool, (int)k);
+        tail = tail->right;
+    }
+    bst::updateSize(root);
+
+    printf("degenerate: %zu sorted keys\n", n);
+    int h = 0, leaves = 0, d = 0, order = 0;
+    bool found = false;
+    double heightMs = timeMs([&] { h = bst::findHeight(root); });
+    double leavesMs = timeMs([&] { leaves = bst::countLeafNodes(root); });
+    double diameterMs = timeMs([&] { bst::findDiameter(root, d); });
+    double searchMs = timeMs([&] { found = bst::searchNode(root, (int)n - 1); });
+    double orderMs = timeMs([&] { order = bst::order_of_key(root, (int)n - 1); });
+    double inorderMs = timeSilentMs([&] { bst::Inorder(root); });
+    printf("  height   %10.2f ms (%d)\n", heightMs, h);
+    printf("  leaves   %10.2f ms (%d)\n", leavesMs, leaves);
+    printf("  diameter %10.2f ms (%d)\n", diameterMs, d);
+    printf("  search   %10.2f ms (%s)\n", searchMs, found ? "found" : "missing");
+    printf("  order    %10.2f ms (%d)\n", orderMs, order);
+    printf("  inorder  %10.2f ms\n", inorderMs);
+    return nullptr;
+}
+
+int main(int argc, char** argv) {
+    size_t n = (size_t)stod(bench::argValue(argc, argv, "--ops", "1e6"));
+    size_t sortedN = (size_t)stod(bench::argValue(argc, argv, "--sorted", "1e7"));
+    size_t sortedInsertN = (size_t)stod(bench::argValue(argc, argv, "--sorted-insert", "2e4"));
+    size_t stackKiB = (size_t)stod(bench::argValue(argc, argv, "--stack-kib", "256"));
+
+    balancedCase(n);
+
+    // Run the degenerate case on a small fixed stack to show it no longer depends on recursion depth
+    printf("\nnative stack for degenerate case: %zu KiB\n", stackKiB);
+    DegenerateArgs args{sortedN, sortedInsertN};
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setstacksize(&attr, stackKiB * 1024);
+    pthread_t thread;
+    pthread_create(&thread, &attr, degenerateCase, &args);
+    pthread_join(thread, nullptr);
+    pthread_attr_destroy(&attr);
+    return 0;
+}
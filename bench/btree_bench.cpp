@@ -0,0 +1,96 @@
+// Wide-node B-tree vs the binary BST and AVL trees.
+//
+// Inserts n keys (random by default) into each tree, all allocating from node pools,
+// then times lookups (about half hits) and order_of_key queries and reports the
+// memory reserved per key.
+//
+//   btree_bench [--ops 1e5,1e6,1e7] [--workload random|sequential|zipfian] [--lookups 1e6] [--seed 42]
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "../src/avl_tree.h"
+#include "../src/binary_search_tree.h"
+#include "../src/btree.h"
+#include "../src/node_pool.h"
+
+using namespace std;
+
+struct Result {
+    double insertsPerSec, searchesPerSec, ranksPerSec, bytesPerKey;
+    size_t size, hits;
+};
+
+template <typename F>
+static double perSec(size_t ops, F f) {
+    uint64_t start = bench::nowNs();
+    f();
+    return ops / ((bench::nowNs() - start) / 1e9);
+}
+
+static void printRow(const char* tree, size_t n, const Result& r) {
+    printf("%-6s %11zu %11zu %13.0f %13.0f %13.0f %12.1f %9zu\n", tree, n, r.size, r.insertsPerSec, r.searchesPerSec,
+           r.ranksPerSec, r.bytesPerKey, r.hits);
+    fflush(stdout);
+}
+
+int main(int argc, char** argv) {
+    vector<size_t> sizes = bench::parseSizes(bench::argValue(argc, argv, "--ops", "1e5,1e6,1e7"));
+    string workload = bench::argValue(argc, argv, "--workload", "random");
+    size_t lookups = (size_t)stod(bench::argValue(argc, argv, "--lookups", "1e6"));
+    uint64_t seed = stoull(bench::argValue(argc, argv, "--seed", "42"));
+
+    printf("%-6s %11s %11s %13s %13s %13s %12s %9s\n", "tree", "n", "keys", "inserts/s", "searches/s", "ranks/s", "bytes/key",
+           "hits");
+    for (size_t n : sizes) {
+        vector<int> keys = bench::makeKeys(workload, n, seed);
+        vector<int> probes = bench::makeKeys("random", lookups, seed + 1);
+        for (size_t i = 0; i < probes.size(); i += 2) probes[i] = keys[(i * 7919) % keys.size()];
+
+        if (workload != "sequential") {
+            // The BST would degrade to a list on sorted input and take hours
+            NodePool<bst::t_node> pool;
+            bst::t_node* root = nullptr;
+            Result r;
+            r.insertsPerSec = perSec(n, [&] { for (int k : keys) root = bst::insertBST(root, k, &pool); });
+            r.hits = 0;
+            r.searchesPerSec = perSec(lookups, [&] { for (int k : probes) r.hits += bst::searchNode(root, k); });
+            size_t sum = 0;
+            r.ranksPerSec = perSec(lookups, [&] { for (int k : probes) sum += bst::order_of_key(root, k); });
+            bench::doNotOptimize(sum);
+            r.size = bst::countNodes(root);
+            r.bytesPerKey = (double)pool.stats().bytesReserved / r.size;
+            printRow("bst", n, r);
+        }
+        {
+            NodePool<avl::AVLNode> pool;
+            avl::AVLNode* root = nullptr;
+            Result r;
+            r.insertsPerSec = perSec(n, [&] { for (int k : keys) root = avl::insert(root, k, &pool); });
+            r.hits = 0;
+            r.searchesPerSec = perSec(lookups, [&] { for (int k : probes) r.hits += avl::searchNode(root, k); });
+            size_t sum = 0;
+            r.ranksPerSec = perSec(lookups, [&] { for (int k : probes) sum += avl::order_of_key(root, k); });
+            bench::doNotOptimize(sum);
+            r.size = avl::countNodes(root);
+            r.bytesPerKey = (double)pool.stats().bytesReserved / r.size;
+            printRow("avl", n, r);
+        }
+        {
+            btree::BTree tree;
+            Result r;
+            r.insertsPerSec = perSec(n, [&] { for (int k : keys) tree.insert(k); });
+            r.hits = 0;
+            r.searchesPerSec = perSec(lookups, [&] { for (int k : probes) r.hits += tree.searchNode(k); });
+            size_t sum = 0;
+            r.ranksPerSec = perSec(lookups, [&] { for (int k : probes) sum += tree.order_of_key(k); });
+            bench::doNotOptimize(sum);
+            r.size = tree.size();
+            r.bytesPerKey = (double)tree.bytesReserved() / r.size;
+            printRow("btree", n, r);
+        }
+    }
+    return 0;
+}
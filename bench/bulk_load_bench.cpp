@@ -0,0 +1,84 @@
+// Bulk loading vs repeated insertion.
+//
+// For each size n: builds the AVL tree and the BST from n sorted keys with
+// buildBalanced / buildBalancedBST and by calling insert once per key, then merges
+// a sorted batch of n/10 new keys into the tree both ways. Repeated BST insertion
+// of sorted keys is O(n^2), so that row uses the keys in shuffled order instead.
+//
+//   bulk_load_bench [--ops 1e6,1e7,1e8] [--batch 0.1] [--seed 42]
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "../src/avl_tree.h"
+#include "../src/binary_search_tree.h"
+
+using namespace std;
+
+template <typename F>
+static double timeMs(F f) {
+    uint64_t start = bench::nowNs();
+    f();
+    return (bench::nowNs() - start) / 1e6;
+}
+
+static void row(const char* tree, const char* method, size_t n, double ms, int height) {
+    printf("%-4s %-22s %11zu %12.1f %12.1f %7d\n", tree, method, n, ms, ms * 1e6 / n, height);
+    fflush(stdout);
+}
+
+int main(int argc, char** argv) {
+    vector<size_t> sizes = bench::parseSizes(bench::argValue(argc, argv, "--ops", "1e6,1e7,1e8"));
+    double batchFraction = stod(bench::argValue(argc, argv, "--batch", "0.1"));
+    uint64_t seed = stoull(bench::argValue(argc, argv, "--seed", "42"));
+
+    printf("%-4s %-22s %11s %12s %12s %7s\n", "tree", "method", "keys", "ms", "ns/key", "height");
+    for (size_t n : sizes) {
+        // Even keys for the tree, odd keys for the batch, so the merge interleaves
+        vector<int> sorted(n);
+        for (size_t i = 0; i < n; i++) sorted[i] = (int)(2 * i);
+        vector<int> shuffled = sorted;
+        shuffle(shuffled.begin(), shuffled.end(), mt19937_64(seed));
+        size_t m = (size_t)(n * batchFraction);
+        vector<int> batch(m);
+        for (size_t i = 0; i < m; i++) batch[i] = (int)(2 * (i * (n / max<size_t>(m, 1))) + 1);
+
+        {
+            NodePool<avl::AVLNode> pool;
+            avl::AVLNode* root = nullptr;
+            double ms = timeMs([&] { root = avl::buildBalanced(sorted, &pool); });
+            row("avl", "buildBalanced", n, ms, avl::findHeight(root));
+            ms = timeMs([&] { root = avl::mergeBatch(root, batch, &pool); });
+            row("avl", "mergeBatch", m, ms, avl::findHeight(root));
+        }
+        {
+            NodePool<avl::AVLNode> pool;
+            avl::AVLNode* root = nullptr;
+            double ms = timeMs([&] { for (int k : sorted) root = avl::insert(root, k, &pool); });
+            row("avl", "insert (sorted)", n, ms, avl::findHeight(root));
+            ms = timeMs([&] { for (int k : batch) root = avl::insert(root, k, &pool); });
+            row("avl", "insert batch", m, ms, avl::findHeight(root));
+        }
+        {
+            NodePool<bst::t_node> pool;
+            bst::t_node* root = nullptr;
+            double ms = timeMs([&] { root = bst::buildBalancedBST(sorted, &pool); });
+            row("bst", "buildBalancedBST", n, ms, bst::findHeight(root));
+            ms = timeMs([&] { root = bst::mergeBatchBST(root, batch, &pool); });
+            row("bst", "mergeBatchBST", m, ms, bst::findHeight(root));
+        }
+        {
+            NodePool<bst::t_node> pool;
+            bst::t_node* root = nullptr;
+            double ms = timeMs([&] { for (int k : shuffled) root = bst::insertBST(root, k, &pool); });
+            row("bst", "insertBST (shuffled)", n, ms, bst::findHeight(root));
+            ms = timeMs([&] { for (int k : batch) root = bst::insertBST(root, k, &pool); });
+            row("bst", "insertBST batch", m, ms, bst::findHeight(root));
+        }
+    }
+    return 0;
+}
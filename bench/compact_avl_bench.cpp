@@ -0,0 +1,85 @@
+// Pointer AVLNode layout vs the compact 32-bit index layout.
+//
+// Inserts n random keys into each and reports insert throughput, bytes per node
+// (heap bytes actually reserved, including malloc overhead for the pointer tree,
+// measured from peak RSS growth) and search ns/op for hits and misses.
+//
+//   compact_avl_bench [--ops 1e6,1e7] [--seed 42]
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include "bench_util.h"
+#include "../src/avl_tree.h"
+#include "../src/compact_avl_tree.h"
+
+using namespace std;
+
+template <typename Build, typename Search>
+static void measure(const char* layout, size_t n, uint64_t seed, Build build, Search search) {
+    vector<int> keys = bench::makeKeys("random", n, seed);
+    vector<int> misses = bench::makeKeys("random", n, seed + 1);
+    long rssBefore = bench::peakRssKiB();
+
+    uint64_t start = bench::nowNs();
+    build(keys);
+    double insertNs = (double)(bench::nowNs() - start) / n;
+    double bytesPerNode = (bench::peakRssKiB() - rssBefore) * 1024.0 / n;
+
+    size_t found = 0;
+    start = bench::nowNs();
+    for (size_t i = 0; i < n; i++) found += search(keys[(i * 7919) % n]);
+    double hitNs = (double)(bench::nowNs() - start) / n;
+    start = bench::nowNs();
+    for (size_t i = 0; i < n; i++) found += search(misses[i] | 1);
+    double missNs = (double)(bench::nowNs() - start) / n;
+    bench::doNotOptimize(found);
+
+    printf("%-8s %11zu %12.1f %12.1f %12.1f %12.1f\n", layout, n, insertNs, bytesPerNode, hitNs, missNs);
+    fflush(stdout);
+}
+
+// Run in a child process so the RSS growth belongs to one layout only
+template <typename F>
+static void isolated(F f) {
+#if defined(__unix__) || defined(__APPLE__)
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0) {
+        f();
+        _exit(0);
+    }
+    waitpid(pid, nullptr, 0);
+#else
+    f();
+#endif
+}
+
+int main(int argc, char** argv) {
+    vector<size_t> sizes = bench::parseSizes(bench::argValue(argc, argv, "--ops", "1e6,1e7"));
+    uint64_t seed = stoull(bench::argValue(argc, argv, "--seed", "42"));
+
+    printf("sizeof(AVLNode) = %zu, sizeof(CompactAVLNode) = %zu\n", sizeof(avl::AVLNode), sizeof(avl::CompactAVLNode));
+    printf("%-8s %11s %12s %12s %12s %12s\n", "layout", "n", "insert ns", "bytes/node", "hit ns/op", "miss ns/op");
+    for (size_t n : sizes) {
+        isolated([&] {
+            avl::AVLNode* root = nullptr;
+            measure("pointer", n, seed,
+                    [&](const vector<int>& keys) { for (int k : keys) root = avl::insert(root, k); },
+                    [&](int key) { return avl::searchNode(root, key); });
+        });
+        isolated([&] {
+            avl::CompactAVLTree tree;
+            measure("compact", n, seed,
+                    [&](const vector<int>& keys) { for (int k : keys) tree.insert(k); },
+                    [&](int key) { return tree.searchNode(key); });
+        });
+    }
+    return 0;
+}
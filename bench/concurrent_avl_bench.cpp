@@ -0,0 +1,150 @@
+// Multi-threaded lookups and inserts: copy-on-write ConcurrentAVLTree vs a locked AVL.
+//
+// Each tree starts with --keys keys (the even ranks of a 2*keys universe, so about
+// half the lookups hit). Every thread then runs --ops operations, each a lookup or,
+// with probability 1 - read-ratio, an insert, on ranks drawn uniformly or from a
+// Zipfian distribution. Reports aggregate throughput and lookup/insert tail latency.
+//
+//   concurrent_avl_bench [--threads 1,2,4,8,16] [--read-ratio 0.95] [--workload random|zipfian]
+//                        [--keys 1e6] [--ops 1e6] [--tree mutex,rwlock,rcu] [--seed 42]
+
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench_util.h"
+#include "../src/avl_tree.h"
+#include "../src/concurrent_avl_tree.h"
+#include "../src/node_pool.h"
+
+using namespace std;
+
+// Spread neighbouring ranks over the key space
+static int keyOf(uint64_t rank) { return (int)(((uint32_t)rank * 2654435761u) & 0x7fffffff); }
+
+// The single-threaded AVL behind one std::mutex
+struct MutexAVL {
+    mutex lock;
+    avl::AVLNode* root = nullptr;
+    NodePool<avl::AVLNode> pool;
+
+    bool searchNode(int key) {
+        lock_guard<mutex> guard(lock);
+        return avl::searchNode(root, key);
+    }
+    void insert(int key) {
+        lock_guard<mutex> guard(lock);
+        root = avl::insert(root, key, &pool);
+    }
+};
+
+// The same with a reader-writer lock, so lookups only wait for inserts
+struct RwLockAVL {
+    shared_mutex lock;
+    avl::AVLNode* root = nullptr;
+    NodePool<avl::AVLNode> pool;
+
+    bool searchNode(int key) {
+        shared_lock<shared_mutex> guard(lock);
+        return avl::searchNode(root, key);
+    }
+    void insert(int key) {
+        unique_lock<shared_mutex> guard(lock);
+        root = avl::insert(root, key, &pool);
+    }
+};
+
+struct Op {
+    int key;
+    bool write;
+};
+
+struct ThreadResult {
+    bench::LatencyHistogram reads, writes;
+    size_t hits = 0;
+};
+
+template <typename Tree>
+static void run(const char* name, size_t initialKeys, const vector<vector<Op>>& plan) {
+    Tree tree;
+    for (size_t r = 0; r < 2 * initialKeys; r += 2) tree.insert(keyOf(r));
+
+    vector<ThreadResult> results(plan.size());
+    vector<thread> threads;
+    uint64_t start = bench::nowNs();
+    for (size_t t = 0; t < plan.size(); t++) {
+        threads.emplace_back([&, t] {
+            ThreadResult& result = results[t];
+            for (const Op& op : plan[t]) {
+                uint64_t begin = bench::nowNs();
+                if (op.write) {
+                    tree.insert(op.key);
+                    result.writes.record(bench::nowNs() - begin);
+                } else {
+                    result.hits += tree.searchNode(op.key);
+                    result.reads.record(bench::nowNs() - begin);
+                }
+            }
+        });
+    }
+    for (thread& th : threads) th.join();
+    double seconds = (bench::nowNs() - start) / 1e9;
+
+    ThreadResult total;
+    for (const ThreadResult& result : results) {
+        total.reads.merge(result.reads);
+        total.writes.merge(result.writes);
+        total.hits += result.hits;
+    }
+    size_t ops = total.reads.count + total.writes.count;
+    printf("%-7s %7zu %10.2f %9llu %9llu %10llu %9llu %10llu %8.1f%%\n", name, plan.size(), ops / seconds / 1e6,
+           (unsigned long long)total.reads.percentile(50), (unsigned long long)total.reads.percentile(99),
+           (unsigned long long)total.reads.percentile(99.9), (unsigned long long)total.writes.percentile(50),
+           (unsigned long long)total.writes.percentile(99), total.reads.count ? 100.0 * total.hits / total.reads.count : 0.0);
+    fflush(stdout);
+}
+
+int main(int argc, char** argv) {
+    vector<size_t> threadCounts = bench::parseSizes(bench::argValue(argc, argv, "--threads", "1,2,4,8,16"));
+    double readRatio = stod(bench::argValue(argc, argv, "--read-ratio", "0.95"));
+    string workload = bench::argValue(argc, argv, "--workload", "random");
+    size_t initialKeys = (size_t)stod(bench::argValue(argc, argv, "--keys", "1e6"));
+    size_t opsPerThread = (size_t)stod(bench::argValue(argc, argv, "--ops", "1e6"));
+    vector<string> trees = bench::parseList(bench::argValue(argc, argv, "--tree", "mutex,rwlock,rcu"));
+    uint64_t seed = stoull(bench::argValue(argc, argv, "--seed", "42"));
+
+    printf("%zu initial keys, %zu ops/thread, %.0f%% lookups, %s ranks\n\n", initialKeys, opsPerThread, readRatio * 100,
+           workload.c_str());
+    printf("%-7s %7s %10s %9s %9s %10s %9s %10s %9s\n", "tree", "threads", "Mops/s", "read p50", "read p99", "read p99.9",
+           "write p50", "write p99", "hit rate");
+
+    for (size_t threads : threadCounts) {
+        // Operation streams are generated up front so the timed loop only touches the tree
+        vector<vector<Op>> plan(threads);
+        for (size_t t = 0; t < threads; t++) {
+            mt19937_64 rng(seed + t);
+            bernoulli_distribution isWrite(1.0 - readRatio);
+            uniform_int_distribution<uint64_t> uniform(0, 2 * initialKeys - 1);
+            unique_ptr<bench::ZipfianGenerator> zipf;
+            if (workload == "zipfian") zipf.reset(new bench::ZipfianGenerator(2 * initialKeys, 0.99, seed + t));
+            plan[t].resize(opsPerThread);
+            for (Op& op : plan[t]) {
+                op.key = keyOf(zipf ? zipf->next() : uniform(rng));
+                op.write = isWrite(rng);
+            }
+        }
+
+        for (const string& tree : trees) {
+            if (tree == "mutex") run<MutexAVL>("mutex", initialKeys, plan);
+            else if (tree == "rwlock") run<RwLockAVL>("rwlock", initialKeys, plan);
+            else if (tree == "rcu") run<avl::ConcurrentAVLTree>("rcu", initialKeys, plan);
+        }
+        printf("\n");
+    }
+    return 0;
+}
@@ -0,0 +1,79 @@
+// Sliding-window insert/erase benchmark for the BST and AVL tree.
+//
+// Fills each tree to a steady-state size S, then repeatedly inserts a new key and
+// erases the oldest one, so the tree size stays at S. Reports mixed-op throughput
+// and the final tree height. Keys are unique ("random" scrambles a counter through
+// a bijective hash; "sequential" uses the counter itself).
+//
+//   erase_bench [--size 1e5,1e6,1e7] [--ops 1e6] [--tree bst,avl] [--workload random]
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "../src/avl_tree.h"
+#include "../src/binary_search_tree.h"
+
+using namespace std;
+
+static int keyAt(size_t i, bool sequential) {
+    if (sequential) return (int)i;
+    // MurmurHash3 finalizer: a bijection on 32 bits, so keys never repeat
+    uint32_t h = (uint32_t)i;
+    h ^= h >> 16;
+    h *= 0x85ebca6b;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35;
+    h ^= h >> 16;
+    return (int)h;
+}
+
+template <typename Insert, typename Erase, typename Height>
+static void run(const char* tree, size_t steady, size_t ops, bool sequential, Insert insert, Erase erase, Height height) {
+    uint64_t start = bench::nowNs();
+    for (size_t i = 0; i < steady; i++) insert(keyAt(i, sequential));
+    double fillMs = (bench::nowNs() - start) / 1e6;
+
+    start = bench::nowNs();
+    for (size_t i = 0; i < ops; i++) {
+        insert(keyAt(steady + i, sequential));
+        erase(keyAt(i, sequential));
+    }
+    double ns = (double)(bench::nowNs() - start);
+
+    printf("%-4s %11zu %10zu %10.0f %14.0f %8d %8.1f\n", tree, steady, ops, fillMs, 2 * ops * 1e9 / ns, height(),
+           log2((double)steady));
+    fflush(stdout);
+}
+
+int main(int argc, char** argv) {
+    vector<size_t> sizes = bench::parseSizes(bench::argValue(argc, argv, "--size", "1e5,1e6,1e7"));
+    size_t ops = (size_t)stod(bench::argValue(argc, argv, "--ops", "1e6"));
+    vector<string> trees = bench::parseList(bench::argValue(argc, argv, "--tree", "bst,avl"));
+    bool sequential = bench::argValue(argc, argv, "--workload", "random") == "sequential";
+
+    printf("%-4s %11s %10s %10s %14s %8s %8s\n", "tree", "steady n", "windows", "fill ms", "ops/s", "height", "log2 n");
+    for (size_t steady : sizes) {
+        for (const string& tree : trees) {
+            if (tree == "bst") {
+                NodePool<bst::t_node> pool;
+                bst::t_node* root = nullptr;
+                run("bst", steady, ops, sequential,
+                    [&](int k) { root = bst::insertBST(root, k, &pool); },
+                    [&](int k) { root = bst::eraseBST(root, k, &pool); },
+                    [&] { return bst::findHeight(root); });
+            } else if (tree == "avl") {
+                NodePool<avl::AVLNode> pool;
+                avl::AVLNode* root = nullptr;
+                run("avl", steady, ops, sequential,
+                    [&](int k) { root = avl::insert(root, k, &pool); },
+                    [&](int k) { root = avl::erase(root, k, &pool); },
+                    [&] { return avl::findHeight(root); });
+            }
+        }
+    }
+    return 0;
+}
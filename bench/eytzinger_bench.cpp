@@ -0,0 +1,77 @@
+// Frozen Eytzinger index vs the pointer-based AVL tree for lookups.
+//
+// For each size, bulk-loads an AVL tree from n random distinct keys, freezes it into
+// an EytzingerIndex and times the same random lookups (about half hits) on the
+// pointer tree, on std::binary_search over the sorted keys, and on the index one query
+// at a time and in interleaved batches. The AVL nodes are allocated in build order,
+// which is the pointer tree's best case.
+//
+//   eytzinger_bench [--ops 1e4,1e5,1e6,1e7,1e8] [--lookups 1e7] [--seed 42]
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "../src/avl_tree.h"
+#include "../src/eytzinger_index.h"
+#include "../src/node_pool.h"
+
+using namespace std;
+
+template <typename F>
+static double lookupsPerSec(size_t lookups, size_t& found, F run) {
+    uint64_t start = bench::nowNs();
+    found = run();
+    return lookups / ((bench::nowNs() - start) / 1e9);
+}
+
+int main(int argc, char** argv) {
+    vector<size_t> sizes = bench::parseSizes(bench::argValue(argc, argv, "--ops", "1e4,1e5,1e6,1e7,1e8"));
+    size_t lookups = (size_t)stod(bench::argValue(argc, argv, "--lookups", "1e7"));
+    uint64_t seed = stoull(bench::argValue(argc, argv, "--seed", "42"));
+
+    printf("%11s %9s %9s %13s %13s %13s %13s %8s\n", "n", "tree MiB", "index MiB", "avl /s", "binsearch /s",
+           "eytzinger /s", "batched /s", "");
+    for (size_t n : sizes) {
+        vector<int> keys = bench::makeKeys("random", n, seed);
+        sort(keys.begin(), keys.end());
+        keys.erase(unique(keys.begin(), keys.end()), keys.end());
+
+        NodePool<avl::AVLNode> pool;
+        avl::AVLNode* root = avl::buildBalanced(keys, &pool);
+        avl::EytzingerIndex index = avl::freeze(root);
+
+        vector<int> probes = bench::makeKeys("random", lookups, seed + 1);
+        for (size_t i = 0; i < probes.size(); i += 2) probes[i] = keys[(i * 7919) % keys.size()];
+        vector<char> found(probes.size());
+
+        size_t hitsTree, hitsSorted, hitsIndex, hitsBatch;
+        double tree = lookupsPerSec(lookups, hitsTree, [&] {
+            size_t hits = 0;
+            for (int key : probes) hits += avl::searchNode(root, key);
+            return hits;
+        });
+        double sorted = lookupsPerSec(lookups, hitsSorted, [&] {
+            size_t hits = 0;
+            for (int key : probes) hits += binary_search(keys.begin(), keys.end(), key);
+            return hits;
+        });
+        double eytzinger = lookupsPerSec(lookups, hitsIndex, [&] {
+            size_t hits = 0;
+            for (int key : probes) hits += index.searchNode(key);
+            return hits;
+        });
+        double batched = lookupsPerSec(lookups, hitsBatch, [&] {
+            index.searchBatch(probes.data(), probes.size(), reinterpret_cast<bool*>(found.data()));
+            return (size_t)count(found.begin(), found.end(), 1);
+        });
+
+        bool same = hitsTree == hitsSorted && hitsTree == hitsIndex && hitsTree == hitsBatch;
+        printf("%11zu %9.1f %9.1f %13.3g %13.3g %13.3g %13.3g %s\n", keys.size(), pool.stats().bytesReserved / 1048576.0,
+               index.bytes() / 1048576.0, tree, sorted, eytzinger, batched, same ? "(match)" : "(MISMATCH)");
+        fflush(stdout);
+    }
+    return 0;
+}
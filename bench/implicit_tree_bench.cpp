@@ -0,0 +1,136 @@
+// Plain binary tree built from a level-order stream: implicit array vs pointer nodes.
+//
+// For each n, builds the tree from n level-order keys ("complete": no -1, and
+// "holes": about 5% of the keys are -1, i.e. missing children) two ways:
+//   pointer   the visualizer's batch loader: pooled t_nodes linked through a queue,
+//             then one updateSize pass
+//   implicit  ImplicitTree::push, children at 2i+1 / 2i+2 in one array
+// then times level order (summing the keys), findHeight and countLeafNodes on each.
+// The slots column is the implicit array's length (holes cost slots). For n up to
+// --quadratic-max the pointer build is also run the way the interactive loop used
+// to, with an updateSize walk after every added child (O(n^2)).
+//
+//   implicit_tree_bench [--ops 1e5,1e6,1e7] [--quadratic-max 2e4] [--seed 42]
+
+#include <cstdio>
+#include <queue>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "../src/binary_tree.h"
+#include "../src/implicit_tree.h"
+#include "../src/node_pool.h"
+
+using namespace std;
+
+static void printRow(const char* stream, size_t n, const char* tree, const char* op, double seconds, size_t nodes,
+                     long long result, size_t slots) {
+    printf("%-8s %9zu %-9s %-10s %11.2f %12.1f %9zu %16lld %10zu\n", stream, n, tree, op, seconds * 1e3,
+           nodes / seconds / 1e6, nodes, result, slots);
+    fflush(stdout);
+}
+
+template <typename F>
+static double timed(F f) {
+    uint64_t start = bench::nowNs();
+    f();
+    return (bench::nowNs() - start) / 1e9;
+}
+
+// Same linking as loadLevelOrderBatch in binary_tree.cpp; with sizeEveryAdd the
+// sizes are refreshed after each child, as the interactive loop did
+static bt::t_node* buildPointer(const vector<int>& keys, NodePool<bt::t_node>* pool, bool sizeEveryAdd) {
+    bt::t_node* root = nullptr;
+    queue<bt::t_node*> q;
+    bt::t_node* parent = nullptr;
+    bool leftNext = true;
+    for (int key : keys) {
+        if (!root) {
+            root = newNode(pool, key);
+            q.push(root);
+            continue;
+        }
+        if (leftNext) {
+            if (q.empty()) break;
+            parent = q.front();
+            q.pop();
+        }
+        if (key != -1) {
+            bt::t_node* child = newNode(pool, key);
+            (leftNext ? parent->left : parent->right) = child;
+            q.push(child);
+            if (sizeEveryAdd) bt::updateSize(root);
+        }
+        leftNext = !leftNext;
+    }
+    if (root) bt::updateSize(root);
+    return root;
+}
+
+int main(int argc, char** argv) {
+    vector<size_t> sizes = bench::parseSizes(bench::argValue(argc, argv, "--ops", "1e5,1e6,1e7"));
+    size_t quadraticMax = (size_t)stod(bench::argValue(argc, argv, "--quadratic-max", "2e4"));
+    uint64_t seed = stoull(bench::argValue(argc, argv, "--seed", "42"));
+
+    printf("%-8s %9s %-9s %-10s %11s %12s %9s %16s %10s\n", "stream", "n", "tree", "op", "ms", "Mnodes/s", "nodes",
+           "result", "slots");
+    for (size_t n : sizes) {
+        for (const char* stream : {"complete", "holes"}) {
+            vector<int> keys = bench::makeKeys("random", n, seed);
+            for (int& k : keys) k = k == -1 || k == bt::ImplicitTree::absent ? 0 : k;
+            if (string(stream) == "holes") {
+                uint64_t x = seed;
+                for (size_t i = 1; i < keys.size(); i++) {
+                    x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+                    if ((x >> 33) % 100 < 5) keys[i] = -1;
+                }
+            }
+
+            if (n <= quadraticMax) {
+                NodePool<bt::t_node> pool;
+                bt::t_node* root = nullptr;
+                double s = timed([&] { root = buildPointer(keys, &pool, true); });
+                printRow(stream, n, "pointer", "build/add", s, bt::countNodes(root), 0, 0);
+            }
+
+            {
+                NodePool<bt::t_node> pool;
+                bt::t_node* root = nullptr;
+                double s = timed([&] { root = buildPointer(keys, &pool, false); });
+                size_t nodes = bt::countNodes(root);
+                printRow(stream, n, "pointer", "build", s, nodes, 0, 0);
+                long long sum = 0;
+                s = timed([&] { core::forEachLevelOrder(root, [&](bt::t_node* node) { sum += node->data; }); });
+                printRow(stream, n, "pointer", "levelorder", s, nodes, sum, 0);
+                int height = 0;
+                s = timed([&] { height = bt::findHeight(root); });
+                printRow(stream, n, "pointer", "height", s, nodes, height, 0);
+                int leaves = 0;
+                s = timed([&] { leaves = bt::countLeafNodes(root); });
+                printRow(stream, n, "pointer", "leaves", s, nodes, leaves, 0);
+            }
+
+            {
+                bt::ImplicitTree tree;
+                double s = timed([&] {
+                    for (int k : keys)
+                        if (!tree.push(k) && tree.gaveUp()) break;
+                });
+                size_t nodes = tree.countNodes(), slots = tree.slotCount();
+                if (tree.gaveUp()) printf("%s %zu: implicit array gave up (too sparse)\n", stream, n);
+                printRow(stream, n, "implicit", "build", s, nodes, 0, slots);
+                long long sum = 0;
+                s = timed([&] { tree.forEachLevelOrder([&](int key) { sum += key; }); });
+                printRow(stream, n, "implicit", "levelorder", s, nodes, sum, slots);
+                int height = 0;
+                s = timed([&] { height = tree.findHeight(); });
+                printRow(stream, n, "implicit", "height", s, nodes, height, slots);
+                int leaves = 0;
+                s = timed([&] { leaves = tree.countLeafNodes(); });
+                printRow(stream, n, "implicit", "leaves", s, nodes, leaves, slots);
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,108 @@
+// Membership and order_of_key on the plain binary tree: tree walk vs hash side-index.
+//
+// For each n, links n pooled nodes into a complete binary tree holding random even
+// keys (so odd keys are sure misses), then times lookups of keys in the tree (hits)
+// and of odd keys (misses):
+//   scan    bt::searchNode / bt::order_of_key, which visit the nodes (only
+//           --scan-lookups queries, they take O(n) each)
+//   index   KeyIndex, an open-addressing table of key -> node and count
+//   bloom   KeyIndex with the Bloom filter checked before the table
+// The build column is the time to index the whole tree; the rank column times
+// order_of_key (for the indexes, after the one-off sort in the sort column).
+// All three must give the same answers.
+//
+//   key_index_bench [--ops 1e5,1e6,1e7] [--lookups 1e6] [--scan-lookups 20] [--seed 42]
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "../src/binary_tree.h"
+#include "../src/key_index.h"
+#include "../src/node_pool.h"
+
+using namespace std;
+
+static double timeMs(uint64_t start) { return (bench::nowNs() - start) / 1e6; }
+
+template <typename F>
+static double nsPerQuery(const vector<int>& probes, long long& result, F query) {
+    uint64_t start = bench::nowNs();
+    long long sum = 0;
+    for (int key : probes) sum += query(key);
+    result = sum;
+    return (double)(bench::nowNs() - start) / probes.size();
+}
+
+int main(int argc, char** argv) {
+    vector<size_t> sizes = bench::parseSizes(bench::argValue(argc, argv, "--ops", "1e5,1e6,1e7"));
+    size_t lookups = (size_t)stod(bench::argValue(argc, argv, "--lookups", "1e6"));
+    size_t scanLookups = (size_t)stod(bench::argValue(argc, argv, "--scan-lookups", "20"));
+    uint64_t seed = stoull(bench::argValue(argc, argv, "--seed", "42"));
+
+    printf("%9s %-6s %9s %8s %9s %12s %12s %9s %12s %6s\n", "n", "search", "build ms", "MiB", "sort ms", "hit ns",
+           "miss ns", "misses", "rank ns", "agree");
+    for (size_t n : sizes) {
+        vector<int> keys = bench::makeKeys("random", n, seed);
+        for (int& k : keys) k &= ~1;
+
+        NodePool<bt::t_node> pool;
+        vector<bt::t_node*> nodes(n);
+        for (size_t i = 0; i < n; i++) nodes[i] = newNode(&pool, keys[i]);
+        for (size_t i = 0; i < n; i++) {
+            if (2 * i + 1 < n) nodes[i]->left = nodes[2 * i + 1];
+            if (2 * i + 2 < n) nodes[i]->right = nodes[2 * i + 2];
+        }
+        bt::t_node* root = nodes[0];
+        bt::updateSize(root);
+        nodes.clear();
+        nodes.shrink_to_fit();
+
+        vector<int> random = bench::makeKeys("random", lookups, seed + 1);
+        vector<int> hits(lookups), misses(lookups), ranks(lookups);
+        for (size_t i = 0; i < lookups; i++) {
+            hits[i] = keys[(size_t)random[i] % n];
+            misses[i] = random[i] | 1;
+            ranks[i] = random[i];
+        }
+
+        // The scan answers for the first scanLookups probes, to check the indexes against
+        vector<int> scanHits(hits.begin(), hits.begin() + min(scanLookups, lookups));
+        vector<int> scanMisses(misses.begin(), misses.begin() + scanHits.size());
+        vector<int> scanRanks(ranks.begin(), ranks.begin() + scanHits.size());
+        long long scanFound, scanFalse, scanRank;
+        double hitNs = nsPerQuery(scanHits, scanFound, [&](int k) { return bt::searchNode(root, k); });
+        double missNs = nsPerQuery(scanMisses, scanFalse, [&](int k) { return bt::searchNode(root, k); });
+        double rankNs = nsPerQuery(scanRanks, scanRank, [&](int k) { return bt::order_of_key(root, k); });
+        printf("%9zu %-6s %9s %8s %9s %12.0f %12.0f %9lld %12.0f %6s\n", n, "scan", "-", "-", "-", hitNs, missNs,
+               (long long)scanMisses.size() - scanFalse, rankNs,
+               scanFound == (long long)scanHits.size() && scanFalse == 0 ? "yes" : "NO");
+        fflush(stdout);
+
+        for (bool bloom : {false, true}) {
+            bt::KeyIndex index(bloom);
+            uint64_t start = bench::nowNs();
+            index.build(root);
+            double buildMs = timeMs(start);
+            start = bench::nowNs();
+            index.order_of_key(0);  // Sorts the keys once
+            double sortMs = timeMs(start);
+
+            long long found, falseHits, rank, prefixRank, prefixFound, prefixFalse;
+            hitNs = nsPerQuery(hits, found, [&](int k) { return index.contains(k); });
+            missNs = nsPerQuery(misses, falseHits, [&](int k) { return index.contains(k); });
+            rankNs = nsPerQuery(ranks, rank, [&](int k) { return index.order_of_key(k); });
+            nsPerQuery(scanHits, prefixFound, [&](int k) { return index.contains(k); });
+            nsPerQuery(scanMisses, prefixFalse, [&](int k) { return index.contains(k); });
+            nsPerQuery(scanRanks, prefixRank, [&](int k) { return index.order_of_key(k); });
+            bool agree = found == (long long)lookups && falseHits == 0 && prefixFound == scanFound &&
+                         prefixFalse == scanFalse && prefixRank == scanRank && index.size() == (int)n;
+            printf("%9zu %-6s %9.1f %8.1f %9.1f %12.1f %12.1f %9zu %12.1f %6s\n", n, bloom ? "bloom" : "index", buildMs,
+                   index.bytes() / 1048576.0, sortMs, hitNs, missNs, lookups, rankNs, agree ? "yes" : "NO");
+            fflush(stdout);
+            bench::doNotOptimize(rank);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,129 @@
+// Batch key input throughput.
+//
+// Writes a key file of the requested size (random ints, text and raw int32), then
+// reports MB/s for: parsing only (mmap and 1 MiB fread chunks), the old
+// `cin >> string; stoi` loop, and parse + insert into the AVL tree / BST.
+//
+//   key_input_bench [--mb 1024] [--dir /tmp] [--tree avl,bst] [--keep]
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "../src/avl_tree.h"
+#include "../src/binary_search_tree.h"
+#include "../src/key_reader.h"
+
+using namespace std;
+
+static size_t writeKeyFiles(const string& textPath, const string& binPath, size_t targetBytes) {
+    FILE* text = fopen(textPath.c_str(), "wb");
+    FILE* bin = fopen(binPath.c_str(), "wb");
+    if (!text || !bin) {
+        fprintf(stderr, "cannot write key files in the given --dir\n");
+        exit(1);
+    }
+    vector<int> chunk = bench::makeKeys("random", 1 << 16, 7);
+    size_t written = 0, keys = 0;
+    char line[16];
+    while (written < targetBytes) {
+        for (int key : chunk) {
+            int len = snprintf(line, sizeof(line), "%d\n", key);
+            fwrite(line, 1, len, text);
+            written += len;
+        }
+        fwrite(chunk.data(), sizeof(int), chunk.size(), bin);
+        keys += chunk.size();
+    }
+    fclose(text);
+    fclose(bin);
+    return keys;
+}
+
+template <typename F>
+static double seconds(F f) {
+    uint64_t start = bench::nowNs();
+    f();
+    return (bench::nowNs() - start) / 1e9;
+}
+
+static void row(const char* what, size_t bytes, size_t keys, double secs) {
+    printf("%-32s %10.1f MB/s %12.1f Mkeys/s\n", what, bytes / 1e6 / secs, keys / 1e6 / secs);
+    fflush(stdout);
+}
+
+int main(int argc, char** argv) {
+    size_t mb = (size_t)stod(bench::argValue(argc, argv, "--mb", "1024"));
+    string dir = bench::argValue(argc, argv, "--dir", "/tmp");
+    vector<string> trees = bench::parseList(bench::argValue(argc, argv, "--tree", "avl,bst"));
+    string textPath = dir + "/tree_keys.txt", binPath = dir + "/tree_keys.bin";
+
+    size_t keys = writeKeyFiles(textPath, binPath, mb << 20);
+    printf("%zu keys: %s (text), %s (bin32)\n\n", keys, textPath.c_str(), binPath.c_str());
+
+    long long sum = 0;
+    KeyReadStats stats;
+    double t = seconds([&] { forEachKey(textPath, KEYS_TEXT, [&](int k) { sum += k; }, &stats); });
+    row("text parse (mmap)", stats.bytes, stats.keys, t);
+
+    stats = KeyReadStats();
+    t = seconds([&] { forEachKey(textPath, KEYS_TEXT, [&](int k) { sum += k; }, &stats, false); });
+    row("text parse (fread chunks)", stats.bytes, stats.keys, t);
+
+    stats = KeyReadStats();
+    t = seconds([&] { forEachKey(binPath, KEYS_BIN32, [&](int k) { sum += k; }, &stats); });
+    row("bin32 decode (mmap)", stats.bytes, stats.keys, t);
+
+    // The per-token loop the interactive programs use
+    size_t baselineKeys = 0, baselineBytes = stats.bytes;
+    {
+        ifstream in(textPath);
+        string token;
+        t = seconds([&] {
+            while (in >> token) {
+                sum += stoi(token);
+                baselineKeys++;
+            }
+        });
+        ifstream sizeProbe(textPath, ios::ate | ios::binary);
+        baselineBytes = (size_t)sizeProbe.tellg();
+    }
+    row("cin >> string + stoi", baselineBytes, baselineKeys, t);
+    bench::doNotOptimize(sum);
+
+    for (const string& tree : trees) {
+        stats = KeyReadStats();
+        if (tree == "avl") {
+            NodePool<avl::AVLNode> pool;
+            avl::AVLNode* root = nullptr;
+            t = seconds([&] { forEachKey(textPath, KEYS_TEXT, [&](int k) { root = avl::insert(root, k, &pool); }, &stats); });
+            row("text parse + avl::insert", stats.bytes, stats.keys, t);
+        } else if (tree == "bst") {
+            NodePool<bst::t_node> pool;
+            bst::t_node* root = nullptr;
+            t = seconds([&] { forEachKey(textPath, KEYS_TEXT, [&](int k) { root = bst::insertBST(root, k, &pool); }, &stats); });
+            row("text parse + insertBST", stats.bytes, stats.keys, t);
+        }
+    }
+
+    {
+        stats = KeyReadStats();
+        NodePool<avl::AVLNode> pool;
+        avl::AVLNode* root = nullptr;
+        t = seconds([&] {
+            vector<int> loaded;
+            forEachKey(binPath, KEYS_BIN32, [&](int k) { loaded.push_back(k); }, &stats);
+            root = avl::bulkLoad(move(loaded), &pool);
+        });
+        row("bin32 decode + avl::bulkLoad", stats.bytes, stats.keys, t);
+    }
+
+    if (!bench::hasFlag(argc, argv, "--keep")) {
+        remove(textPath.c_str());
+        remove(binPath.c_str());
+    }
+    return 0;
+}
@@ -0,0 +1,147 @@
+// Visualizer layout: the precomputed TreeLayout vs the old recursive printTree placement.
+//
+// For random BST and AVL trees of n nodes:
+//   legacy  the placement the visualizers used before tree_layout.h: a recursive walk
+//           that calls findHeight on every node and halves the offset with pow each
+//           level (the drawing calls themselves are left out)
+//   build   TreeLayout::build, one O(n) pass, plus the pixel positions from a Viewport
+//   update  per-insert cost of keeping the layout current while --inserts more keys
+//           go into the tree with TreeLayout::inserted
+//   rebuild the same inserts with the layout built again after each one
+// The overlaps column counts pairs of nodes on the same row whose circles (radius 20)
+// intersect. --verify checks the incrementally updated layout against a fresh build.
+//
+//   layout_bench [--ops 1e3,1e4,1e5] [--inserts 1000] [--seed 42] [--verify]
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bench_util.h"
+#include "../src/avl_tree.h"
+#include "../src/binary_search_tree.h"
+#include "../src/node_pool.h"
+#include "../src/tree_layout.h"
+
+using namespace std;
+
+static const int radius = 20;
+
+static void printRow(const char* tree, size_t n, const char* method, size_t ops, double seconds, long long overlaps) {
+    printf("%-4s %9zu %-7s %8zu %13.2f %10lld\n", tree, n, method, ops, seconds * 1e6 / ops, overlaps);
+    fflush(stdout);
+}
+
+// Pairs of same-row nodes drawn closer than a node's diameter, from (row, x) positions
+static long long countOverlaps(vector<pair<int, int>>& positions) {
+    sort(positions.begin(), positions.end());
+    long long overlaps = 0;
+    for (size_t i = 0; i < positions.size(); i++)
+        for (size_t j = i + 1; j < positions.size() && positions[j].first == positions[i].first &&
+                               positions[j].second - positions[i].second < 2 * radius;
+             j++)
+            overlaps++;
+    return overlaps;
+}
+
+// The old placement: findHeight on every node, offsets 300 / 2^(level + 1)
+template <typename N>
+static void legacyPlace(N* root, int x, int y, int level, vector<pair<int, int>>& positions, long long& heights) {
+    if (!root) return;
+    heights += core::findHeight(root);
+    positions.push_back({y, x});
+    int offset = 300 / pow(2, level + 1);
+    legacyPlace(root->left, x - offset, y + 100, level + 1, positions, heights);
+    legacyPlace(root->right, x + offset, y + 100, level + 1, positions, heights);
+}
+
+template <typename N>
+static vector<pair<int, int>> layoutPositions(const core::TreeLayout<N>& layout, N* root) {
+    core::Viewport view = core::Viewport::fit(root, 400, 100, 760, 100, radius + 4, 150);
+    vector<pair<int, int>> positions;
+    positions.reserve(layout.size());
+    layout.forEach([&](N*, int column, int depth) { positions.push_back({view.y(depth), view.x(column)}); });
+    return positions;
+}
+
+template <typename N>
+static bool sameLayout(const core::TreeLayout<N>& a, const core::TreeLayout<N>& b) {
+    if (a.size() != b.size()) return false;
+    for (int c = 0; c < a.size(); c++)
+        if (a.slot(c).node != b.slot(c).node || a.slot(c).depth != b.slot(c).depth) return false;
+    return true;
+}
+
+template <typename N, typename Insert>
+static void run(const char* tree, const vector<int>& keys, const vector<int>& extra, bool verify, Insert insert) {
+    size_t n = keys.size();
+    NodePool<N> pool;
+    N* root = nullptr;
+    for (int k : keys) root = insert(root, k, &pool);
+
+    vector<pair<int, int>> positions;
+    long long heights = 0;
+    uint64_t start = bench::nowNs();
+    legacyPlace(root, 400, 100, 0, positions, heights);
+    double seconds = (bench::nowNs() - start) / 1e9;
+    bench::doNotOptimize(heights);
+    printRow(tree, n, "legacy", 1, seconds, countOverlaps(positions));
+
+    core::TreeLayout<N> layout;
+    start = bench::nowNs();
+    layout.build(root);
+    positions = layoutPositions(layout, root);
+    seconds = (bench::nowNs() - start) / 1e9;
+    printRow(tree, n, "build", 1, seconds, countOverlaps(positions));
+
+    // Same extra keys into two copies of the tree, one layout kept per method
+    NodePool<N> rebuildPool;
+    N* rebuildRoot = nullptr;
+    for (int k : keys) rebuildRoot = insert(rebuildRoot, k, &rebuildPool);
+    core::TreeLayout<N> rebuilt;
+    rebuilt.build(rebuildRoot);
+
+    uint64_t incremental = 0, rebuild = 0;
+    for (int k : extra) {
+        root = insert(root, k, &pool);
+        start = bench::nowNs();
+        layout.inserted(root, k);
+        incremental += bench::nowNs() - start;
+
+        rebuildRoot = insert(rebuildRoot, k, &rebuildPool);
+        start = bench::nowNs();
+        rebuilt.build(rebuildRoot);
+        rebuild += bench::nowNs() - start;
+    }
+    positions = layoutPositions(layout, root);
+    printRow(tree, n, "update", extra.size(), incremental / 1e9, countOverlaps(positions));
+    positions = layoutPositions(rebuilt, rebuildRoot);
+    printRow(tree, n, "rebuild", extra.size(), rebuild / 1e9, countOverlaps(positions));
+
+    if (verify) {
+        core::TreeLayout<N> fresh;
+        fresh.build(root);
+        if (!sameLayout(layout, fresh)) printf("%s: incremental layout differs from a fresh build\n", tree);
+    }
+}
+
+int main(int argc, char** argv) {
+    vector<size_t> sizes = bench::parseSizes(bench::argValue(argc, argv, "--ops", "1e3,1e4,1e5"));
+    size_t inserts = (size_t)stod(bench::argValue(argc, argv, "--inserts", "1000"));
+    uint64_t seed = stoull(bench::argValue(argc, argv, "--seed", "42"));
+    bool verify = bench::hasFlag(argc, argv, "--verify");
+
+    printf("%-4s %9s %-7s %8s %13s %10s\n", "tree", "n", "method", "ops", "us/op", "overlaps");
+    for (size_t n : sizes) {
+        vector<int> keys = bench::makeKeys("random", n, seed);
+        vector<int> extra = bench::makeKeys("random", inserts, seed + 1);
+        run<bst::t_node>("bst", keys, extra, verify,
+                         [](bst::t_node* root, int k, NodePool<bst::t_node>* pool) { return bst::insertBST(root, k, pool); });
+        run<avl::AVLNode>("avl", keys, extra, verify,
+                          [](avl::AVLNode* root, int k, NodePool<avl::AVLNode>* pool) { return avl::insert(root, k, pool); });
+    }
+    return 0;
+}
@@ -0,0 +1,174 @@
+// Key -> value map workload: tree map mode vs std::map and the tree + side hash map.
+//
+// For each n, inserts n keys with an 8-byte value (try_emplace), looks up --lookups
+// keys (about half hits) and reads their values, then runs n upserts over zipfian
+// keys (mostly updates of hot keys, some inserts). "avl+hash" is the previous setup:
+// an avl tree for the ordered keys plus an unordered_map for the payloads, so every
+// operation touches both. The string rows repeat insert and find with std::string
+// keys looked up through std::string_view (transparent std::less<>).
+//
+//   map_bench [--ops 1e5,1e6,1e7] [--lookups 1e6] [--seed 42]
+
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "bench_util.h"
+#include "../src/avl_tree.h"
+#include "../src/node_pool.h"
+#include "../src/tree_map.h"
+
+using namespace std;
+
+struct Result {
+    double insertsPerSec, findsPerSec, upsertsPerSec;
+    size_t size;
+    uint64_t checksum;  // Sum of the values found, equal across maps
+};
+
+template <typename F>
+static double perSec(size_t ops, F f) {
+    uint64_t start = bench::nowNs();
+    f();
+    return ops / ((bench::nowNs() - start) / 1e9);
+}
+
+static void printRow(const char* map, size_t n, const Result& r) {
+    printf("%-10s %11zu %11zu %13.0f %13.0f %13.0f %20llu\n", map, n, r.size, r.insertsPerSec, r.findsPerSec,
+           r.upsertsPerSec, (unsigned long long)r.checksum);
+    fflush(stdout);
+}
+
+// Run the three phases through the map's own calls
+template <typename Map, typename Insert, typename Find, typename Upsert, typename Size>
+static Result measure(Map& map, const vector<int>& keys, const vector<int>& probes, const vector<int>& hot,
+                      Insert insertFn, Find findFn, Upsert upsertFn, Size sizeFn) {
+    Result r;
+    r.insertsPerSec = perSec(keys.size(), [&] {
+        for (size_t i = 0; i < keys.size(); i++) insertFn(map, keys[i], (uint64_t)i);
+    });
+    r.checksum = 0;
+    r.findsPerSec = perSec(probes.size(), [&] {
+        for (int k : probes) r.checksum += findFn(map, k);
+    });
+    r.upsertsPerSec = perSec(hot.size(), [&] {
+        for (size_t i = 0; i < hot.size(); i++) upsertFn(map, hot[i], (uint64_t)i);
+    });
+    r.size = sizeFn(map);
+    return r;
+}
+
+int main(int argc, char** argv) {
+    vector<size_t> sizes = bench::parseSizes(bench::argValue(argc, argv, "--ops", "1e5,1e6,1e7"));
+    size_t lookups = (size_t)stod(bench::argValue(argc, argv, "--lookups", "1e6"));
+    uint64_t seed = stoull(bench::argValue(argc, argv, "--seed", "42"));
+
+    printf("%-10s %11s %11s %13s %13s %13s %20s\n", "map", "n", "size", "inserts/s", "finds/s", "upserts/s",
+           "checksum");
+    for (size_t n : sizes) {
+        vector<int> keys = bench::makeKeys("random", n, seed);
+        vector<int> probes = bench::makeKeys("random", lookups, seed + 1);
+        for (size_t i = 0; i < probes.size(); i += 2) probes[i] = keys[(i * 7919) % keys.size()];
+        vector<int> hot = bench::makeKeys("zipfian", n, seed + 2);
+
+        {
+            map<int, uint64_t> m;
+            printRow("std::map", n,
+                     measure(m, keys, probes, hot, [](auto& m, int k, uint64_t v) { m.try_emplace(k, v); },
+                             [](auto& m, int k) -> uint64_t {
+                                 auto it = m.find(k);
+                                 return it == m.end() ? 0 : it->second;
+                             },
+                             [](auto& m, int k, uint64_t v) { m.insert_or_assign(k, v); },
+                             [](auto& m) { return m.size(); }));
+        }
+        {
+            struct TreeAndHash {
+                NodePool<avl::AVLNode> pool;
+                avl::AVLNode* root = nullptr;
+                unordered_map<int, uint64_t> values;
+            } m;
+            printRow("avl+hash", n,
+                     measure(m, keys, probes, hot,
+                             [](TreeAndHash& m, int k, uint64_t v) {
+                                 if (avl::searchNode(m.root, k)) return;
+                                 m.root = avl::insert(m.root, k, &m.pool);
+                                 m.values.emplace(k, v);
+                             },
+                             [](TreeAndHash& m, int k) -> uint64_t {
+                                 if (!avl::searchNode(m.root, k)) return 0;
+                                 return m.values.find(k)->second;
+                             },
+                             [](TreeAndHash& m, int k, uint64_t v) {
+                                 m.root = avl::insert(m.root, k, &m.pool);
+                                 m.values[k] = v;
+                             },
+                             [](TreeAndHash& m) { return (size_t)avl::countNodes(m.root); }));
+        }
+        auto treeMapRow = [&](const char* name, auto& m) {
+            printRow(name, n,
+                     measure(m, keys, probes, hot, [](auto& m, int k, uint64_t v) { m.try_emplace(k, v); },
+                             [](auto& m, int k) -> uint64_t {
+                                 const uint64_t* v = m.find(k);
+                                 return v ? *v : 0;
+                             },
+                             [](auto& m, int k, uint64_t v) { m.upsert(k, v); },
+                             [](auto& m) { return (size_t)m.size(); }));
+        };
+        {
+            bst::TreeMap<int, uint64_t> m;
+            treeMapRow("bst map", m);
+        }
+        {
+            avl::TreeMap<int, uint64_t> m;
+            treeMapRow("avl map", m);
+        }
+
+        // String keys, looked up through string_view without building a std::string
+        vector<string> names(n);
+        char buf[32];
+        for (size_t i = 0; i < n; i++) {
+            snprintf(buf, sizeof buf, "user:%010d", keys[i]);
+            names[i] = buf;
+        }
+        vector<string> probeNames(probes.size());
+        for (size_t i = 0; i < probes.size(); i++) {
+            snprintf(buf, sizeof buf, "user:%010d", probes[i]);
+            probeNames[i] = buf;
+        }
+        auto stringRow = [&](const char* name, auto& m, auto insertFn, auto findFn) {
+            Result r;
+            r.insertsPerSec = perSec(n, [&] {
+                for (size_t i = 0; i < n; i++) insertFn(m, names[i], (uint64_t)i);
+            });
+            r.checksum = 0;
+            r.findsPerSec = perSec(probeNames.size(), [&] {
+                for (const string& s : probeNames) r.checksum += findFn(m, string_view(s));
+            });
+            r.upsertsPerSec = 0;
+            r.size = m.size();
+            printRow(name, n, r);
+        };
+        {
+            map<string, uint64_t, less<>> m;
+            stringRow("std::map s", m, [](auto& m, const string& k, uint64_t v) { m.try_emplace(k, v); },
+                      [](auto& m, string_view k) -> uint64_t {
+                          auto it = m.find(k);
+                          return it == m.end() ? 0 : it->second;
+                      });
+        }
+        {
+            avl::TreeMap<string, uint64_t> m;
+            stringRow("avl map s", m, [](auto& m, const string& k, uint64_t v) { m.try_emplace(k, v); },
+                      [](auto& m, string_view k) -> uint64_t {
+                          const uint64_t* v = m.find(k);
+                          return v ? *v : 0;
+                      });
+        }
+    }
+    return 0;
+}
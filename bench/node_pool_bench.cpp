@@ -0,0 +1,157 @@
+// NodePool vs plain new for the three trees.
+//
+// For each tree, builds n random keys with operator new and again with a NodePool,
+// then times searches over each and the teardown of the whole tree (a delete walk
+// vs NodePool::release). A final allocator-only churn phase shows free-list reuse.
+//
+//   node_pool_bench [--ops 1e7] [--tree bt,bst,avl] [--linear-cap 2000] [--seed 42]
+
+#include <cstdio>
+#include <queue>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "../src/avl_tree.h"
+#include "../src/binary_search_tree.h"
+#include "../src/binary_tree.h"
+#include "../src/node_pool.h"
+
+using namespace std;
+
+static double msSince(uint64_t start) { return (bench::nowNs() - start) / 1e6; }
+
+// Delete every node of a tree built with plain new
+template <typename Node>
+static void deleteTree(Node* root) {
+    vector<Node*> stack;
+    if (root) stack.push_back(root);
+    while (!stack.empty()) {
+        Node* node = stack.back();
+        stack.pop_back();
+        if (node->left) stack.push_back(node->left);
+        if (node->right) stack.push_back(node->right);
+        delete node;
+    }
+}
+
+// Level-order attach, as main() in binary_tree.cpp does
+static bt::t_node* buildBinaryTree(const vector<int>& keys, NodePool<bt::t_node>* pool) {
+    bt::t_node* root = nullptr;
+    queue<bt::t_node*> open;
+    bool leftNext = true;
+    for (int key : keys) {
+        bt::t_node* node = newNode(pool, key);
+        open.push(node);
+        if (!root) {
+            root = node;
+            continue;
+        }
+        if (leftNext) {
+            open.front()->left = node;
+        } else {
+            open.front()->right = node;
+            open.pop();
+        }
+        leftNext = !leftNext;
+    }
+    return root;
+}
+
+static void printRow(const char* tree, const char* alloc, size_t n, double buildMs, double searchNsPerOp, double teardownMs,
+                     const PoolStats* stats) {
+    printf("%-4s %-5s %11zu %13.0f %12.1f %12.2f", tree, alloc, n, n / buildMs * 1e3, searchNsPerOp, teardownMs);
+    if (stats) printf(" %11.1f MiB", stats->bytesReserved / 1048576.0);
+    printf("\n");
+    fflush(stdout);
+}
+
+template <typename Node, typename Build, typename Search>
+static void compare(const char* tree, const vector<int>& keys, size_t searches, Build build, Search search) {
+    for (int usePool = 0; usePool < 2; usePool++) {
+        NodePool<Node> pool;
+        NodePool<Node>* p = usePool ? &pool : nullptr;
+
+        uint64_t start = bench::nowNs();
+        Node* root = build(keys, p);
+        double buildMs = msSince(start);
+
+        size_t found = 0;
+        start = bench::nowNs();
+        for (size_t i = 0; i < searches; i++) found += search(root, keys[(i * 7919) % keys.size()]);
+        double searchNs = (double)(bench::nowNs() - start) / searches;
+        bench::doNotOptimize(found);
+
+        PoolStats stats = pool.stats();
+        start = bench::nowNs();
+        if (usePool) pool.release();
+        else deleteTree(root);
+        double teardownMs = msSince(start);
+
+        printRow(tree, usePool ? "pool" : "new", keys.size(), buildMs, searchNs, teardownMs, usePool ? &stats : nullptr);
+    }
+}
+
+// Allocate n nodes, free every other one, then allocate n/2 again
+static void churn(size_t n) {
+    uint64_t start = bench::nowNs();
+    vector<avl::AVLNode*> nodes(n);
+    for (size_t i = 0; i < n; i++) nodes[i] = new avl::AVLNode((int)i);
+    for (size_t i = 0; i < n; i += 2) delete nodes[i];
+    for (size_t i = 0; i < n; i += 2) nodes[i] = new avl::AVLNode((int)i);
+    for (avl::AVLNode* node : nodes) delete node;
+    double newMs = msSince(start);
+
+    NodePool<avl::AVLNode> pool;
+    start = bench::nowNs();
+    for (size_t i = 0; i < n; i++) nodes[i] = pool.create((int)i);
+    for (size_t i = 0; i < n; i += 2) pool.destroy(nodes[i]);
+    PoolStats holes = pool.stats();
+    for (size_t i = 0; i < n; i += 2) nodes[i] = pool.create((int)i);
+    PoolStats refilled = pool.stats();
+    pool.release();
+    double poolMs = msSince(start);
+
+    printf("\nchurn (%zu alloc, %zu free, %zu realloc): new %.1f ms, pool %.1f ms\n", n, (n + 1) / 2, (n + 1) / 2, newMs, poolMs);
+    printf("  after frees:   live %zu, free-listed %zu, fragmentation %.2f\n", holes.liveNodes, holes.freeNodes, holes.fragmentation);
+    printf("  after reuse:   live %zu, free-listed %zu, fragmentation %.2f, reserved %.1f MiB\n", refilled.liveNodes,
+           refilled.freeNodes, refilled.fragmentation, refilled.bytesReserved / 1048576.0);
+}
+
+int main(int argc, char** argv) {
+    size_t n = (size_t)stod(bench::argValue(argc, argv, "--ops", "1e7"));
+    vector<string> trees = bench::parseList(bench::argValue(argc, argv, "--tree", "bt,bst,avl"));
+    size_t linearCap = (size_t)stod(bench::argValue(argc, argv, "--linear-cap", "2000"));
+    uint64_t seed = stoull(bench::argValue(argc, argv, "--seed", "42"));
+
+    vector<int> keys = bench::makeKeys("random", n, seed);
+    printf("%-4s %-5s %11s %13s %12s %12s %15s\n", "tree", "alloc", "n", "inserts/s", "search ns/op", "teardown ms", "reserved");
+
+    for (const string& tree : trees) {
+        if (tree == "bt") {
+            compare<bt::t_node>("bt", keys, min(n, linearCap), buildBinaryTree,
+                                [](bt::t_node* root, int key) { return bt::searchNode(root, key); });
+        } else if (tree == "bst") {
+            compare<bst::t_node>(
+                "bst", keys, n,
+                [](const vector<int>& ks, NodePool<bst::t_node>* pool) {
+                    bst::t_node* root = nullptr;
+                    for (int k : ks) root = bst::insertBST(root, k, pool);
+                    return root;
+                },
+                [](bst::t_node* root, int key) { return bst::searchNode(root, key); });
+        } else if (tree == "avl") {
+            compare<avl::AVLNode>(
+                "avl", keys, n,
+                [](const vector<int>& ks, NodePool<avl::AVLNode>* pool) {
+                    avl::AVLNode* root = nullptr;
+                    for (int k : ks) root = avl::insert(root, k, pool);
+                    return root;
+                },
+                [](avl::AVLNode* root, int key) { return avl::searchNode(root, key); });
+        }
+    }
+
+    churn(n);
+    return 0;
+}
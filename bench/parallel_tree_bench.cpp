@@ -0,0 +1,87 @@
+// Fork-join structural analytics vs the serial binary tree walks.
+//
+// Builds a level-order (complete) binary tree of n nodes, as binary_tree.cpp does,
+// times the serial findHeight / countLeafNodes / findDiameter / searchNode, then
+// parallelStats and parallelSearchNode on a TaskPool of each thread count. Searches
+// look for a missing key so every node is visited. 10^8 nodes need about 3 GiB.
+//
+// Subtrees are forked while they hold at least parallelGrain nodes (the tree's sizes
+// are filled in when it is built); --spawn-depth caps the forking depth. Without
+// cached sizes the depth is the only cutoff, which splits a full tree evenly but
+// leaves most tasks empty and one holding nearly everything on a skewed tree.
+//
+//   parallel_tree_bench [--ops 1e8] [--threads 1,2,4,8,16] [--spawn-depth 12]
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "../src/binary_tree.h"
+#include "../src/node_pool.h"
+#include "../src/parallel_tree.h"
+
+using namespace std;
+using bt::t_node;
+
+template <typename F>
+static double timeMs(F f) {
+    uint64_t start = bench::nowNs();
+    f();
+    return (bench::nowNs() - start) / 1e6;
+}
+
+// Node i gets children 2i+1 and 2i+2; keys are 0..n-1
+static t_node* buildComplete(size_t n, NodePool<t_node>& pool) {
+    vector<t_node*> nodes(n);
+    for (size_t i = 0; i < n; i++) nodes[i] = pool.create((int)i);
+    for (size_t i = n; i-- > 0;) {  // Children first, so their sizes are ready
+        if (2 * i + 1 < n) nodes[i]->left = nodes[2 * i + 1];
+        if (2 * i + 2 < n) nodes[i]->right = nodes[2 * i + 2];
+        core::updateNode(nodes[i]);
+    }
+    return n ? nodes[0] : nullptr;
+}
+
+int main(int argc, char** argv) {
+    size_t n = (size_t)stod(bench::argValue(argc, argv, "--ops", "1e8"));
+    vector<size_t> threadCounts = bench::parseSizes(bench::argValue(argc, argv, "--threads", "1,2,4,8,16"));
+    int spawnDepth = stoi(bench::argValue(argc, argv, "--spawn-depth", "12"));
+
+    NodePool<t_node> pool;
+    t_node* root = buildComplete(n, pool);
+    const int missing = -1;
+
+    int height = 0, leaves = 0, diameter = 0;
+    bool found = true;
+    double heightMs = timeMs([&] { height = bt::findHeight(root); });
+    double leavesMs = timeMs([&] { leaves = bt::countLeafNodes(root); });
+    double diameterMs = timeMs([&] { bt::findDiameter(root, diameter); });
+    double searchMs = timeMs([&] { found = bt::searchNode(root, missing); });
+    double serialMs = heightMs + leavesMs + diameterMs;
+    printf("n = %zu, height %d, leaves %d, diameter %d, %u hardware threads\n", n, height, leaves, diameter,
+           thread::hardware_concurrency());
+    printf("serial walks: height %.1f ms + leaves %.1f ms + diameter %.1f ms = %.1f ms, search %.1f ms\n\n", heightMs, leavesMs,
+           diameterMs, serialMs, searchMs);
+
+    printf("%7s %12s %9s %12s %9s %s\n", "threads", "stats ms", "speedup", "search ms", "speedup", "");
+    double baseStatsMs = 0, baseSearchMs = 0;
+    for (size_t threads : threadCounts) {
+        TaskPool tasks((unsigned)threads);
+        TreeStats stats;
+        bool parallelFound = true;
+        double statsMs = timeMs([&] { stats = parallelStats(root, tasks, spawnDepth); });
+        double parallelSearchMs = timeMs([&] { parallelFound = parallelSearchNode(root, missing, tasks, spawnDepth); });
+        if (baseStatsMs == 0) {
+            baseStatsMs = statsMs;
+            baseSearchMs = parallelSearchMs;
+        }
+
+        bool same = stats.height == height && stats.leaves == leaves && stats.diameter == diameter && parallelFound == found &&
+                    stats.size == (int)n;
+        printf("%7zu %12.1f %8.2fx %12.1f %8.2fx %s\n", threads, statsMs, baseStatsMs / statsMs, parallelSearchMs,
+               baseSearchMs / parallelSearchMs, same ? "(match)" : "(MISMATCH)");
+        fflush(stdout);
+    }
+    return 0;
+}
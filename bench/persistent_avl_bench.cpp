@@ -0,0 +1,81 @@
+// Persistent (path-copying) AVL vs the mutable AVL tree.
+//
+// Inserts n random keys into the mutable tree (avl::insert) and into a
+// PersistentAVLTree while keeping a snapshot every k inserts (k = 0 keeps none),
+// then erases them all again. Reports insert/erase throughput, the number of live
+// nodes and the extra memory each retained version costs.
+//
+//   persistent_avl_bench [--ops 1e6] [--snapshot-every 0,1000,10,1] [--seed 42]
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "../src/avl_tree.h"
+#include "../src/persistent_avl_tree.h"
+
+using namespace std;
+using avl::PersistentAVLTree;
+
+static double msSince(uint64_t start) { return (bench::nowNs() - start) / 1e6; }
+
+static void printRow(const char* tree, const string& every, double insertMs, double eraseMs, size_t n, size_t versions,
+                     size_t live, size_t nodeBytes) {
+    printf("%-10s %8s %12.0f %12.0f %9zu %12zu", tree, every.c_str(), n / insertMs * 1e3, n / eraseMs * 1e3, versions, live);
+    if (versions) printf(" %12.0f B", (double)(live - n) * nodeBytes / versions);
+    printf("\n");
+    fflush(stdout);
+}
+
+int main(int argc, char** argv) {
+    size_t n = (size_t)stod(bench::argValue(argc, argv, "--ops", "1e6"));
+    vector<size_t> everyList = bench::parseSizes(bench::argValue(argc, argv, "--snapshot-every", "0,1000,10,1"));
+    uint64_t seed = stoull(bench::argValue(argc, argv, "--seed", "42"));
+
+    // Distinct keys, so the live-node count after the inserts is exactly n plus old versions
+    vector<int> keys = bench::makeKeys("random", n, seed);
+    sort(keys.begin(), keys.end());
+    keys.erase(unique(keys.begin(), keys.end()), keys.end());
+    shuffle(keys.begin(), keys.end(), mt19937_64(seed));
+    n = keys.size();
+
+    printf("%zu keys, %zu B per mutable node, %zu B per persistent node\n\n", n, sizeof(avl::AVLNode),
+           sizeof(avl::PersistentAVLNode));
+    printf("%-10s %8s %12s %12s %9s %12s %14s\n", "tree", "snapshot", "inserts/s", "erases/s", "versions", "live nodes",
+           "bytes/version");
+
+    {
+        avl::AVLNode* root = nullptr;
+        uint64_t start = bench::nowNs();
+        for (int key : keys) root = avl::insert(root, key);
+        double insertMs = msSince(start);
+        start = bench::nowNs();
+        for (int key : keys) root = avl::erase(root, key);
+        double eraseMs = msSince(start);
+        printRow("mutable", "-", insertMs, eraseMs, n, 0, n, sizeof(avl::AVLNode));
+    }
+
+    for (size_t every : everyList) {
+        vector<PersistentAVLTree> versions;
+        PersistentAVLTree tree;
+        uint64_t start = bench::nowNs();
+        for (size_t i = 0; i < n; i++) {
+            tree.insert(keys[i]);
+            if (every && (i + 1) % every == 0) versions.push_back(tree.snapshot());
+        }
+        double insertMs = msSince(start);
+        size_t live = PersistentAVLTree::liveNodes();
+
+        // The retained versions stay alive during the erases, as they would for a long scan
+        start = bench::nowNs();
+        for (int key : keys) tree.erase(key);
+        double eraseMs = msSince(start);
+
+        printRow("persistent", every ? to_string(every) : "none", insertMs, eraseMs, n, versions.size(), live,
+                 sizeof(avl::PersistentAVLNode));
+    }
+    return 0;
+}
@@ -0,0 +1,131 @@
+// Inserts per second with visualization on: full redraws vs damage-region redraws.
+//
+// Starts from a random BST or AVL tree of n nodes and inserts --inserts more random
+// keys, drawing after each one into an 800x600 Framebuffer standing in for the
+// window (visualizer scale: 24-pixel columns, off-screen subtrees culled):
+//   full    clear the screen and draw the whole frame after every insert, as the
+//           visualizers did (they then slept 200 or 500 ms, capping them at 5 or 2
+//           inserts/s; the sleep is left out here)
+//   damage  record the frame and let Redrawer repaint only what changed
+//   paced   damage redraws at most 30 times a second (FramePacer); inserts between
+//           frames are coalesced into the next one
+// The keys are a shuffled permutation of 0 .. n + inserts - 1, short enough that most
+// fit inside a node, so labels are drawn and damaged like everything else (labels is
+// the number drawn in the final frame). The repainted column is the average share of
+// the screen repainted per frame. At the end each screen is compared with a fresh
+// full draw of the final tree.
+//
+//   redraw_bench [--ops 1e2,1e3,1e4,1e5] [--inserts 2000] [--seed 42]
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "../src/avl_tree.h"
+#include "../src/binary_search_tree.h"
+#include "../src/node_pool.h"
+#include "../src/tree_redraw.h"
+#include "../src/tree_render.h"
+
+using namespace std;
+
+static const int width = 800, height = 600;
+
+static void printRow(const char* tree, size_t n, const char* mode, size_t inserts, double seconds, int frames,
+                     double repainted, int labels, bool same) {
+    printf("%-4s %9zu %-7s %8zu %13.0f %7d %10.1f%% %7d %6s\n", tree, n, mode, inserts, inserts / seconds, frames,
+           repainted * 100, labels, same ? "yes" : "NO");
+    fflush(stdout);
+}
+
+static bool sameImage(const core::Framebuffer& a, const core::Framebuffer& b) {
+    for (int y = 0; y < height; y++)
+        for (int x = 0; x < width; x++)
+            if (a.pixel(x, y) != b.pixel(x, y)) return false;
+    return true;
+}
+
+template <typename N, typename Insert>
+static void run(const char* tree, const vector<int>& keys, const vector<int>& extra, Insert insert) {
+    core::RenderStyle style;
+    auto viewOf = [](N* root) { return core::Viewport::fit(root, width / 2, 100, width - 40, 60, 24.0, 150.0); };
+
+    // The final tree drawn from scratch, to check each mode's screen against
+    auto reference = [&](N* root) {
+        core::Framebuffer expected(width, height);
+        core::renderTree(root, viewOf(root), expected, style);
+        return expected;
+    };
+
+    // Labels in the final frame
+    auto labels = [&](N* root) {
+        core::DisplayList list(width, height, 4 * core::Framebuffer::glyphScale, 5 * core::Framebuffer::glyphScale);
+        core::renderTree(root, viewOf(root), list, style);
+        return (int)count_if(list.items().begin(), list.items().end(),
+                             [](const core::DrawOp& op) { return op.kind == core::DrawOp::TEXT; });
+    };
+
+    for (const char* mode : {"full", "damage", "paced"}) {
+        NodePool<N> pool;
+        N* root = nullptr;
+        for (int k : keys) root = insert(root, k, &pool);
+
+        core::Framebuffer screen(width, height);
+        core::DisplayList frame(width, height, 4 * core::Framebuffer::glyphScale, 5 * core::Framebuffer::glyphScale);
+        core::Redrawer redrawer;
+        core::FramePacer pacer;
+        bool pending = false;
+        int frames = 0;
+        double repainted = 0;
+        string m = mode;
+
+        auto draw = [&] {
+            if (m == "full") {
+                core::renderTree(root, viewOf(root), screen, style);
+                repainted += 1;
+            } else {
+                core::renderTree(root, viewOf(root), frame, style);
+                repainted += (double)redrawer.present(frame, screen).pixels / (width * height);
+                pacer.drawn();
+            }
+            frames++;
+            pending = false;
+        };
+
+        draw();  // The tree as loaded is on screen before the timed inserts
+        frames = 0;
+        repainted = 0;
+        uint64_t start = bench::nowNs();
+        for (int k : extra) {
+            root = insert(root, k, &pool);
+            pending = true;
+            if (m != "paced" || pacer.due()) draw();
+        }
+        if (pending) draw();
+        double seconds = (bench::nowNs() - start) / 1e9;
+        printRow(tree, keys.size(), mode, extra.size(), seconds, frames, frames ? repainted / frames : 0, labels(root),
+                 sameImage(screen, reference(root)));
+    }
+}
+
+int main(int argc, char** argv) {
+    vector<size_t> sizes = bench::parseSizes(bench::argValue(argc, argv, "--ops", "1e2,1e3,1e4,1e5"));
+    size_t inserts = (size_t)stod(bench::argValue(argc, argv, "--inserts", "2000"));
+    uint64_t seed = stoull(bench::argValue(argc, argv, "--seed", "42"));
+
+    printf("%-4s %9s %-7s %8s %13s %7s %11s %7s %6s\n", "tree", "n", "mode", "inserts", "inserts/s", "frames",
+           "repainted", "labels", "same");
+    for (size_t n : sizes) {
+        vector<int> all = bench::makeKeys("sequential", n + inserts, seed);
+        shuffle(all.begin(), all.end(), mt19937_64(seed));
+        vector<int> keys(all.begin(), all.begin() + n), extra(all.begin() + n, all.end());
+        run<bst::t_node>("bst", keys, extra,
+                         [](bst::t_node* root, int k, NodePool<bst::t_node>* pool) { return bst::insertBST(root, k, pool); });
+        run<avl::AVLNode>("avl", keys, extra,
+                          [](avl::AVLNode* root, int k, NodePool<avl::AVLNode>* pool) { return avl::insert(root, k, pool); });
+    }
+    return 0;
+}
@@ -0,0 +1,135 @@
+// Offscreen rendering: frame time against node count for tree_render.h.
+//
+// Builds random BST and AVL trees of n nodes and renders 800x600 frames into a
+// Framebuffer (and the fitted view also as SVG into a temporary file):
+//   fit    the whole tree fitted into the frame, as --render draws it
+//   zoom   24-pixel columns around the root, the interactive visualizer's scale
+//   pan    24-pixel columns centred on the node at rank n/3, deep in the tree
+//   nolod  the whole tree with level of detail off and rows squeezed to fit the
+//          height: every node is drawn, which is what drawing it node by node costs
+// The counts show how much each frame drew: nodes, aggregate glyphs for collapsed
+// subtrees, and nodes culled as off the frame.
+//
+//   render_bench [--ops 1e3,1e4,1e5,1e6] [--seed 42] [--write prefix]
+// With --write, each Framebuffer frame is also saved as <prefix>-<tree>-<n>-<view>.ppm.
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "../src/avl_tree.h"
+#include "../src/binary_search_tree.h"
+#include "../src/node_pool.h"
+#include "../src/tree_render.h"
+
+using namespace std;
+
+static const int width = 800, height = 600;
+
+static void printRow(const char* tree, size_t n, const char* view, const char* canvas, int frames, double seconds,
+                     const core::RenderStats& s) {
+    printf("%-4s %9zu %-6s %-6s %7d %11.3f %8d %10d %10d %10d\n", tree, n, view, canvas, frames, seconds * 1e3 / frames,
+           s.nodes, s.aggregates, s.collapsed, s.culled);
+    fflush(stdout);
+}
+
+// Frames until about 0.2 s have passed (at least 3)
+template <typename F>
+static int timeFrames(F frame, double& seconds) {
+    int frames = 0;
+    uint64_t start = bench::nowNs();
+    do {
+        frame();
+        frames++;
+    } while (frames < 3 || (frames < 1000 && bench::nowNs() - start < 200000000ULL));
+    seconds = (bench::nowNs() - start) / 1e9;
+    return frames;
+}
+
+// Depth of the node at inorder rank k
+template <typename N>
+static int depthOfRank(N* root, int k) {
+    int depth = 0;
+    while (root) {
+        int left = core::getSize(root->left);
+        if (k == left) break;
+        if (k < left) {
+            root = root->left;
+        } else {
+            k -= left + 1;
+            root = root->right;
+        }
+        depth++;
+    }
+    return depth;
+}
+
+template <typename N>
+static void run(const char* tree, N* root, size_t n, const string& prefix) {
+    core::RenderStyle style;
+    int margin = style.radius + 20;
+    core::Viewport fit = core::Viewport::fit(root, width / 2, margin, width - 2 * margin, 3 * style.radius, 0.0, 150.0);
+    core::Viewport zoom = core::Viewport::fit(root, width / 2, margin, width - 2 * margin, 3 * style.radius, 24.0, 24.0);
+    core::Viewport pan = zoom;
+    int target = (int)n / 3;
+    pan.rootX = width / 2 - (int)((target - pan.rootColumn) * pan.columnWidth);
+    pan.rootY = height / 2 - depthOfRank(root, target) * pan.rowHeight;
+    core::RenderStyle noLod = style;
+    noLod.lodPixels = 0;
+    core::Viewport all = fit;
+    all.rowHeight = max(1, (height - 2 * margin) / max(1, core::findHeight(root) - 1));
+
+    struct View {
+        const char* name;
+        core::Viewport view;
+        const core::RenderStyle* style;
+    } views[] = {{"fit", fit, &style}, {"zoom", zoom, &style}, {"pan", pan, &style}, {"nolod", all, &noLod}};
+
+    core::Framebuffer frame(width, height);
+    for (const View& v : views) {
+        core::RenderStats stats;
+        double seconds;
+        int frames = timeFrames([&] { stats = core::renderTree(root, v.view, frame, *v.style); }, seconds);
+        printRow(tree, n, v.name, "fb", frames, seconds, stats);
+        if (!prefix.empty()) frame.writePPM(prefix + "-" + tree + "-" + to_string(n) + "-" + v.name + ".ppm");
+    }
+
+    FILE* out = tmpfile();
+    if (!out) return;
+    core::RenderStats stats;
+    double seconds;
+    int frames = timeFrames([&] {
+        rewind(out);
+        core::SvgCanvas svg(out, width, height);
+        stats = core::renderTree(root, fit, svg, style);
+        svg.finish();
+        fflush(out);
+    }, seconds);
+    printRow(tree, n, "fit", "svg", frames, seconds, stats);
+    fclose(out);
+}
+
+int main(int argc, char** argv) {
+    vector<size_t> sizes = bench::parseSizes(bench::argValue(argc, argv, "--ops", "1e3,1e4,1e5,1e6"));
+    uint64_t seed = stoull(bench::argValue(argc, argv, "--seed", "42"));
+    string prefix = bench::argValue(argc, argv, "--write", "");
+
+    printf("%-4s %9s %-6s %-6s %7s %11s %8s %10s %10s %10s\n", "tree", "n", "view", "canvas", "frames", "ms/frame",
+           "nodes", "aggregates", "collapsed", "culled");
+    for (size_t n : sizes) {
+        vector<int> keys = bench::makeKeys("random", n, seed);
+        NodePool<bst::t_node> bstPool;
+        NodePool<avl::AVLNode> avlPool;
+        bst::t_node* bstRoot = nullptr;
+        avl::AVLNode* avlRoot = nullptr;
+        for (int k : keys) {
+            bstRoot = bst::insertBST(bstRoot, k, &bstPool);
+            avlRoot = avl::insert(avlRoot, k, &avlPool);
+        }
+        run("bst", bstRoot, n, prefix);
+        run("avl", avlRoot, (size_t)avl::countNodes(avlRoot), prefix);
+    }
+    return 0;
+}
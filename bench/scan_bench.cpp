@@ -0,0 +1,106 @@
+// Ordered range scans: tree iterators vs std::set and a full inorder walk.
+//
+// Builds the BST and AVL tree (and a std::set) from n random keys, then for each
+// range length k runs scans of about k keys starting at random keys: range(lo, hi)
+// on the trees, lower_bound + iteration on std::set, and, for comparison, what a
+// scan cost before iterators existed: a whole-tree inorder walk that skips keys out
+// of range (O(n) per scan, so it is only run a few times). Sums of the scanned keys
+// are printed so the methods can be checked against each other (the walk only
+// covers its first few scans).
+//
+//   scan_bench [--ops 1e6] [--lengths 10,100,1e4,1e6] [--seed 42]
+
+#include <algorithm>
+#include <cstdio>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "../src/avl_tree.h"
+#include "../src/binary_search_tree.h"
+#include "../src/node_pool.h"
+
+using namespace std;
+
+static void printRow(const char* method, size_t n, size_t k, size_t scans, double seconds, size_t keys,
+                     long long checksum) {
+    printf("%-8s %11zu %9zu %8zu %13.0f %14.0f %20lld\n", method, n, k, scans, scans / seconds, keys / seconds,
+           checksum);
+    fflush(stdout);
+}
+
+int main(int argc, char** argv) {
+    vector<size_t> sizes = bench::parseSizes(bench::argValue(argc, argv, "--ops", "1e6"));
+    vector<size_t> lengths = bench::parseSizes(bench::argValue(argc, argv, "--lengths", "10,100,1e4,1e6"));
+    uint64_t seed = stoull(bench::argValue(argc, argv, "--seed", "42"));
+
+    printf("%-8s %11s %9s %8s %13s %14s %20s\n", "method", "n", "k", "scans", "scans/s", "keys/s", "checksum");
+    for (size_t n : sizes) {
+        vector<int> keys = bench::makeKeys("random", n, seed);
+        NodePool<bst::t_node> bstPool;
+        NodePool<avl::AVLNode> avlPool;
+        bst::t_node* bstRoot = nullptr;
+        avl::AVLNode* avlRoot = nullptr;
+        for (int k : keys) {
+            bstRoot = bst::insertBST(bstRoot, k, &bstPool);
+            avlRoot = avl::insert(avlRoot, k, &avlPool);
+        }
+        set<int> ordered(keys.begin(), keys.end());
+        vector<int> sorted(ordered.begin(), ordered.end());
+
+        for (size_t k : lengths) {
+            // Each scan covers [lo, hi] with about k distinct keys
+            size_t scans = min<size_t>(100000, max<size_t>(10, 4000000 / k));
+            vector<pair<int, int>> bounds(scans);
+            uint64_t x = seed + k;
+            for (auto& b : bounds) {
+                x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+                size_t first = (x >> 33) % sorted.size();
+                size_t last = min(sorted.size() - 1, first + k - 1);
+                b = {sorted[first], sorted[last]};
+            }
+
+            auto timeScans = [&](const char* method, size_t count, auto scan) {
+                size_t visited = 0;
+                long long sum = 0;
+                uint64_t start = bench::nowNs();
+                for (size_t i = 0; i < count; i++) scan(bounds[i].first, bounds[i].second, visited, sum);
+                printRow(method, n, k, count, (bench::nowNs() - start) / 1e9, visited, sum);
+            };
+
+            timeScans("avl", scans, [&](int lo, int hi, size_t& visited, long long& sum) {
+                for (int key : avl::range(avlRoot, lo, hi)) {
+                    sum += key;
+                    visited++;
+                }
+            });
+            timeScans("bst", scans, [&](int lo, int hi, size_t& visited, long long& sum) {
+                // Duplicate keys are skipped so the sums match the AVL tree and std::set
+                bool first = true;
+                int previous = 0;
+                for (int key : bst::range(bstRoot, lo, hi)) {
+                    if (!first && key == previous) continue;
+                    first = false;
+                    previous = key;
+                    sum += key;
+                    visited++;
+                }
+            });
+            timeScans("std::set", scans, [&](int lo, int hi, size_t& visited, long long& sum) {
+                for (auto it = ordered.lower_bound(lo); it != ordered.end() && *it <= hi; ++it) {
+                    sum += *it;
+                    visited++;
+                }
+            });
+            timeScans("walk", min<size_t>(scans, 5), [&](int lo, int hi, size_t& visited, long long& sum) {
+                core::forEachInorder(avlRoot, [&](avl::AVLNode* node) {
+                    if (node->data < lo || node->data > hi) return;
+                    sum += node->data;
+                    visited++;
+                });
+            });
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,166 @@
+// Headless benchmark driver for the three trees.
+//
+// Runs scripted insert/search workloads (sequential, random or Zipfian keys) against
+// the binary tree, BST, AVL tree and wide-node B-tree and reports ops/sec, ns/op
+// percentiles and peak RSS.
+//
+//   tree_bench [--tree bt,bst,avl,btree] [--workload sequential,random,zipfian]
+//              [--ops 1000,1e5] [--seed 42] [--linear-cap 10000]
+//
+// Every (tree, workload, size) combination runs in its own child process so the
+// reported peak RSS belongs to that tree alone.
+
+#include <cstdio>
+#include <queue>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include "bench_util.h"
+#include "../src/avl_tree.h"
+#include "../src/binary_search_tree.h"
+#include "../src/binary_tree.h"
+#include "../src/btree.h"
+
+using namespace std;
+
+struct PhaseResult {
+    size_t ops;
+    uint64_t totalNs;
+    bench::LatencyHistogram hist;
+};
+
+static void report(const string& tree, const string& workload, size_t n, const char* phase, const PhaseResult& r) {
+    double opsPerSec = r.totalNs ? r.ops * 1e9 / r.totalNs : 0;
+    printf("%-5s %-10s %11zu %-7s %13.0f %8llu %8llu %8llu %9llu %10llu %10ld\n",
+           tree.c_str(), workload.c_str(), n, phase, opsPerSec,
+           (unsigned long long)r.hist.percentile(50), (unsigned long long)r.hist.percentile(90),
+           (unsigned long long)r.hist.percentile(99), (unsigned long long)r.hist.percentile(99.9),
+           (unsigned long long)r.hist.maxNs, bench::peakRssKiB());
+    fflush(stdout);
+}
+
+// Time op(i) for i in [0, ops), recording every call in the histogram
+template <typename Op>
+static PhaseResult timePhase(size_t ops, Op op) {
+    PhaseResult r;
+    r.ops = ops;
+    uint64_t start = bench::nowNs();
+    for (size_t i = 0; i < ops; i++) {
+        uint64_t t0 = bench::nowNs();
+        op(i);
+        r.hist.record(bench::nowNs() - t0);
+    }
+    r.totalNs = bench::nowNs() - start;
+    return r;
+}
+
+static void runBinaryTree(const string& workload, const vector<int>& keys, size_t linearCap) {
+    // Nodes are attached in level order, the same way main() in binary_tree.cpp builds the tree
+    bt::t_node* root = nullptr;
+    queue<bt::t_node*> open;
+    bool leftNext = true;
+    PhaseResult ins = timePhase(keys.size(), [&](size_t i) {
+        bt::t_node* node = new bt::t_node(keys[i]);
+        if (!root) {
+            root = node;
+            open.push(node);
+            return;
+        }
+        bt::t_node* parent = open.front();
+        if (leftNext) {
+            parent->left = node;
+        } else {
+            parent->right = node;
+            open.pop();
+        }
+        leftNext = !leftNext;
+        open.push(node);
+    });
+    bt::updateSize(root);
+    report("bt", workload, keys.size(), "insert", ins);
+
+    // Unordered search is O(n) per lookup, so cap the number of lookups
+    size_t searches = min(keys.size(), linearCap);
+    size_t found = 0;
+    PhaseResult srch = timePhase(searches, [&](size_t i) { found += bt::searchNode(root, keys[(i * 7919) % keys.size()]); });
+    bench::doNotOptimize(found);
+    report("bt", workload, keys.size(), "search", srch);
+}
+
+static void runBST(const string& workload, const vector<int>& keys) {
+    bst::t_node* root = nullptr;
+    PhaseResult ins = timePhase(keys.size(), [&](size_t i) { root = bst::insertBST(root, keys[i]); });
+    report("bst", workload, keys.size(), "insert", ins);
+
+    size_t found = 0;
+    PhaseResult srch = timePhase(keys.size(), [&](size_t i) { found += bst::searchNode(root, keys[(i * 7919) % keys.size()]); });
+    bench::doNotOptimize(found);
+    report("bst", workload, keys.size(), "search", srch);
+}
+
+static void runAVL(const string& workload, const vector<int>& keys) {
+    avl::AVLNode* root = nullptr;
+    PhaseResult ins = timePhase(keys.size(), [&](size_t i) { root = avl::insert(root, keys[i]); });
+    report("avl", workload, keys.size(), "insert", ins);
+
+    size_t found = 0;
+    PhaseResult srch = timePhase(keys.size(), [&](size_t i) { found += avl::searchNode(root, keys[(i * 7919) % keys.size()]); });
+    bench::doNotOptimize(found);
+    report("avl", workload, keys.size(), "search", srch);
+}
+
+static void runBTree(const string& workload, const vector<int>& keys) {
+    btree::BTree tree;
+    PhaseResult ins = timePhase(keys.size(), [&](size_t i) { tree.insert(keys[i]); });
+    report("btree", workload, keys.size(), "insert", ins);
+
+    size_t found = 0;
+    PhaseResult srch = timePhase(keys.size(), [&](size_t i) { found += tree.searchNode(keys[(i * 7919) % keys.size()]); });
+    bench::doNotOptimize(found);
+    report("btree", workload, keys.size(), "search", srch);
+}
+
+static void runOne(const string& tree, const string& workload, size_t n, uint64_t seed, size_t linearCap) {
+    vector<int> keys = bench::makeKeys(workload, n, seed);
+    if (tree == "bt") runBinaryTree(workload, keys, linearCap);
+    else if (tree == "bst") runBST(workload, keys);
+    else if (tree == "avl") runAVL(workload, keys);
+    else if (tree == "btree") runBTree(workload, keys);
+    else fprintf(stderr, "unknown tree '%s'\n", tree.c_str());
+}
+
+int main(int argc, char** argv) {
+    vector<string> trees = bench::parseList(bench::argValue(argc, argv, "--tree", "bt,bst,avl,btree"));
+    vector<string> workloads = bench::parseList(bench::argValue(argc, argv, "--workload", "sequential,random,zipfian"));
+    vector<size_t> sizes = bench::parseSizes(bench::argValue(argc, argv, "--ops", "1000"));
+    uint64_t seed = stoull(bench::argValue(argc, argv, "--seed", "42"));
+    size_t linearCap = (size_t)stod(bench::argValue(argc, argv, "--linear-cap", "10000"));
+
+    printf("%-5s %-10s %11s %-7s %13s %8s %8s %8s %9s %10s %10s\n",
+           "tree", "workload", "n", "phase", "ops/s", "p50(ns)", "p90(ns)", "p99(ns)", "p99.9(ns)", "max(ns)", "rss(KiB)");
+    fflush(stdout);
+
+    for (size_t n : sizes)
+        for (const string& workload : workloads)
+            for (const string& tree : trees) {
+#if defined(__unix__) || defined(__APPLE__)
+                pid_t pid = fork();
+                if (pid == 0) {
+                    runOne(tree, workload, n, seed, linearCap);
+                    _exit(0);
+                }
+                int status = 0;
+                waitpid(pid, &status, 0);
+                if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+                    printf("%-5s %-10s %11zu crashed (status %d)\n", tree.c_str(), workload.c_str(), n, status);
+#else
+                runOne(tree, workload, n, seed, linearCap);
+#endif
+            }
+    return 0;
+}
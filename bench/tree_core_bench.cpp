@@ -0,0 +1,269 @@
+// Generic tree core vs the hand-written int trees it replaced.
+//
+// The "int" rows run copies of the int-only BST and AVL code as it stood before
+// tree_core.h; the "core" rows run the same workload through core::Node<Key, Augment>
+// instantiations. Every tree allocates from a node pool. Reported per tree: inserts/s,
+// searches/s (about half hits), and the time for one findHeight and one countLeafNodes
+// walk. The core rows should match or beat the int rows; the extra rows show the
+// augmentation policies and other key types.
+//
+//   tree_core_bench [--ops 1e5,1e6,1e7] [--lookups 1e6] [--seed 42]
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "../src/node_pool.h"
+#include "../src/tree_core.h"
+
+using namespace std;
+
+// The int-only implementations, as previously duplicated in the tree headers
+namespace handwritten {
+
+struct t_node {
+    int data;
+    t_node* left;
+    t_node* right;
+    int size;
+
+    t_node(int x) : data(x), left(nullptr), right(nullptr), size(1) {}
+};
+
+inline t_node* insertBST(t_node* root, int key, NodePool<t_node>* pool) {
+    if (!root) return newNode(pool, key);
+    t_node* current = root;
+    while (true) {
+        current->size++;
+        t_node*& next = (key < current->data) ? current->left : current->right;
+        if (!next) {
+            next = newNode(pool, key);
+            return root;
+        }
+        current = next;
+    }
+}
+
+struct AVLNode {
+    int data;
+    AVLNode* left;
+    AVLNode* right;
+    int height;
+    int size;
+
+    AVLNode(int x) : data(x), left(nullptr), right(nullptr), height(1), size(1) {}
+};
+
+inline int getHeight(AVLNode* node) { return node ? node->height : 0; }
+inline int getSize(AVLNode* node) { return node ? node->size : 0; }
+
+inline void updateHeightAndSize(AVLNode* node) {
+    node->height = 1 + max(getHeight(node->left), getHeight(node->right));
+    node->size = 1 + getSize(node->left) + getSize(node->right);
+}
+
+inline AVLNode* rightRotate(AVLNode* y) {
+    AVLNode* x = y->left;
+    y->left = x->right;
+    x->right = y;
+    updateHeightAndSize(y);
+    updateHeightAndSize(x);
+    return x;
+}
+
+inline AVLNode* leftRotate(AVLNode* x) {
+    AVLNode* y = x->right;
+    x->right = y->left;
+    y->left = x;
+    updateHeightAndSize(x);
+    updateHeightAndSize(y);
+    return y;
+}
+
+inline AVLNode* insert(AVLNode* node, int key, NodePool<AVLNode>* pool) {
+    if (node == nullptr) return newNode(pool, key);
+    if (key < node->data)
+        node->left = insert(node->left, key, pool);
+    else if (key > node->data)
+        node->right = insert(node->right, key, pool);
+    else
+        return node;
+
+    updateHeightAndSize(node);
+    int balance = getHeight(node->left) - getHeight(node->right);
+    if (balance > 1 && key < node->left->data) return rightRotate(node);
+    if (balance < -1 && key > node->right->data) return leftRotate(node);
+    if (balance > 1 && key > node->left->data) {
+        node->left = leftRotate(node->left);
+        return rightRotate(node);
+    }
+    if (balance < -1 && key < node->right->data) {
+        node->right = rightRotate(node->right);
+        return leftRotate(node);
+    }
+    return node;
+}
+
+template <typename N>
+inline bool searchNode(N* root, int key) {
+    while (root) {
+        if (root->data == key) return true;
+        root = key < root->data ? root->left : root->right;
+    }
+    return false;
+}
+
+// BST: breadth-first level count; AVL: the cached root height
+inline int findHeight(t_node* root) {
+    if (!root) return 0;
+    int height = 0;
+    vector<t_node*> level{root}, next;
+    while (!level.empty()) {
+        height++;
+        next.clear();
+        for (t_node* node : level) {
+            if (node->left) next.push_back(node->left);
+            if (node->right) next.push_back(node->right);
+        }
+        level.swap(next);
+    }
+    return height;
+}
+
+inline int findHeight(AVLNode* root) { return getHeight(root); }
+
+// The AVL header counted leaves recursively, the BST header with an explicit stack
+inline int countLeafNodes(AVLNode* root) {
+    if (root == nullptr) return 0;
+    if (root->left == nullptr && root->right == nullptr) return 1;
+    return countLeafNodes(root->left) + countLeafNodes(root->right);
+}
+
+inline int countLeafNodes(t_node* root) {
+    int leaves = 0;
+    vector<t_node*> stack;
+    while (root || !stack.empty()) {
+        if (!root) {
+            root = stack.back();
+            stack.pop_back();
+        }
+        if (!root->left && !root->right) leaves++;
+        if (root->right) stack.push_back(root->right);
+        root = root->left;
+    }
+    return leaves;
+}
+
+}  // namespace handwritten
+
+struct Result {
+    double insertsPerSec, searchesPerSec, heightMs, leavesMs;
+    size_t hits;
+    int height, leaves;
+};
+
+template <typename F>
+static double elapsedSec(F f) {
+    uint64_t start = bench::nowNs();
+    f();
+    return (bench::nowNs() - start) / 1e9;
+}
+
+static void printRow(const char* tree, size_t n, const Result& r) {
+    printf("%-18s %11zu %13.0f %13.0f %10.2f %10.2f %8d %10d %9zu\n", tree, n, r.insertsPerSec, r.searchesPerSec,
+           r.heightMs, r.leavesMs, r.height, r.leaves, r.hits);
+    fflush(stdout);
+}
+
+// Insert keys through insertFn, then time searches and the two walks
+template <typename N, typename Key, typename Insert, typename Search, typename Height, typename Leaves>
+static Result measure(const vector<Key>& keys, const vector<Key>& probes, Insert insertFn, Search searchFn,
+                      Height heightFn, Leaves leavesFn) {
+    NodePool<N> pool;
+    N* root = nullptr;
+    Result r;
+    r.insertsPerSec = keys.size() / elapsedSec([&] { for (const Key& k : keys) root = insertFn(root, k, &pool); });
+    r.hits = 0;
+    r.searchesPerSec = probes.size() / elapsedSec([&] { for (const Key& k : probes) r.hits += searchFn(root, k); });
+    r.heightMs = 1e3 * elapsedSec([&] { r.height = heightFn(root); });
+    r.leavesMs = 1e3 * elapsedSec([&] { r.leaves = leavesFn(root); });
+    return r;
+}
+
+// Fixed-width text key; pool nodes are never destroyed, so keys must be trivially destructible
+struct Text {
+    char chars[12];
+};
+
+struct TextLess {
+    bool operator()(const Text& a, const Text& b) const { return memcmp(a.chars, b.chars, sizeof a.chars) < 0; }
+};
+
+// Run one core::Node instantiation as an unbalanced BST or as an AVL tree
+template <typename N, bool Avl, typename Compare = less<typename N::key_type>>
+static Result measureCore(const vector<typename N::key_type>& keys, const vector<typename N::key_type>& probes) {
+    using Key = typename N::key_type;
+    return measure<N>(
+        keys, probes,
+        [](N* root, const Key& k, NodePool<N>* pool) {
+            if constexpr (Avl) return core::insertAVL(root, k, pool, Compare());
+            else return core::insertBST(root, k, pool, Compare());
+        },
+        [](N* root, const Key& k) { return core::searchNode(root, k, Compare()); },
+        [](N* root) { return core::findHeight(root); }, [](N* root) { return core::countLeafNodes(root); });
+}
+
+int main(int argc, char** argv) {
+    vector<size_t> sizes = bench::parseSizes(bench::argValue(argc, argv, "--ops", "1e5,1e6,1e7"));
+    size_t lookups = (size_t)stod(bench::argValue(argc, argv, "--lookups", "1e6"));
+    uint64_t seed = stoull(bench::argValue(argc, argv, "--seed", "42"));
+
+    printf("%-18s %11s %13s %13s %10s %10s %8s %10s %9s\n", "tree", "n", "inserts/s", "searches/s", "height ms",
+           "leaves ms", "height", "leaves", "hits");
+    for (size_t n : sizes) {
+        vector<int> keys = bench::makeKeys("random", n, seed);
+        vector<int> probes = bench::makeKeys("random", lookups, seed + 1);
+        for (size_t i = 0; i < probes.size(); i += 2) probes[i] = keys[(i * 7919) % keys.size()];
+
+        printRow("bst int", n,
+                 measure<handwritten::t_node>(
+                     keys, probes, handwritten::insertBST,
+                     [](handwritten::t_node* root, int k) { return handwritten::searchNode(root, k); },
+                     [](handwritten::t_node* root) { return handwritten::findHeight(root); },
+                     [](handwritten::t_node* root) { return handwritten::countLeafNodes(root); }));
+        printRow("bst core<size>", n, measureCore<core::Node<int, core::SizeAugment>, false>(keys, probes));
+        printRow("bst core<none>", n, measureCore<core::Node<int, core::NoAugment>, false>(keys, probes));
+        printRow("bst core<height>", n, measureCore<core::Node<int, core::HeightAugment>, false>(keys, probes));
+
+        printRow("avl int", n,
+                 measure<handwritten::AVLNode>(
+                     keys, probes, handwritten::insert,
+                     [](handwritten::AVLNode* root, int k) { return handwritten::searchNode(root, k); },
+                     [](handwritten::AVLNode* root) { return handwritten::findHeight(root); },
+                     [](handwritten::AVLNode* root) { return handwritten::countLeafNodes(root); }));
+        printRow("avl core<size,h>", n, measureCore<core::Node<int, core::SizeHeightAugment>, true>(keys, probes));
+        printRow("avl core<height>", n, measureCore<core::Node<int, core::HeightAugment>, true>(keys, probes));
+
+        // Other key types through the same code
+        vector<int64_t> wideKeys(keys.begin(), keys.end()), wideProbes(probes.begin(), probes.end());
+        for (int64_t& k : wideKeys) k <<= 31;
+        for (int64_t& k : wideProbes) k <<= 31;
+        printRow("avl core<int64>", n,
+                 measureCore<core::Node<int64_t, core::SizeHeightAugment>, true>(wideKeys, wideProbes));
+
+        vector<Text> textKeys(keys.size()), textProbes(probes.size());
+        auto toText = [](int k, Text& t) {
+            char buf[16];
+            snprintf(buf, sizeof buf, "%011d", k);
+            memcpy(t.chars, buf, sizeof t.chars);
+        };
+        for (size_t i = 0; i < keys.size(); i++) toText(keys[i], textKeys[i]);
+        for (size_t i = 0; i < probes.size(); i++) toText(probes[i], textProbes[i]);
+        printRow("avl core<text>", n,
+                 measureCore<core::Node<Text, core::SizeHeightAugment>, true, TextLess>(textKeys, textProbes));
+    }
+    return 0;
+}
@@ -0,0 +1,79 @@
+// Single-pass structural statistics vs one walk per menu item.
+//
+// Builds a skewed (sorted-insert shape) and a random BST of n nodes and compares
+// computeStats() against the separate findHeight / updateSize / countLeafNodes /
+// findDiameter walks plus the old height-per-node isBalanced.
+//
+//   tree_stats_bench [--ops 1e7] [--seed 42]
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "../src/binary_search_tree.h"
+#include "../src/tree_stats.h"
+
+using namespace std;
+using bst::t_node;
+
+// The isBalanced the tree files used before: a full height walk at every node
+static bool naiveIsBalanced(t_node* root) {
+    if (!root) return true;
+    int leftHeight = bst::findHeight(root->left);
+    int rightHeight = bst::findHeight(root->right);
+    if (abs(leftHeight - rightHeight) > 1) return false;
+    return naiveIsBalanced(root->left) && naiveIsBalanced(root->right);
+}
+
+template <typename F>
+static double timeMs(F f) {
+    uint64_t start = bench::nowNs();
+    f();
+    return (bench::nowNs() - start) / 1e6;
+}
+
+static void compare(const char* shape, t_node* root) {
+    TreeStats separate;
+    double heightMs = timeMs([&] { separate.height = bst::findHeight(root); });
+    double sizeMs = timeMs([&] { separate.size = bst::updateSize(root); });
+    double leavesMs = timeMs([&] { separate.leaves = bst::countLeafNodes(root); });
+    double diameterMs = timeMs([&] { bst::findDiameter(root, separate.diameter); });
+    double balancedMs = timeMs([&] { separate.balanced = naiveIsBalanced(root); });
+    double separateMs = heightMs + sizeMs + leavesMs + diameterMs + balancedMs;
+
+    TreeStats single;
+    double singleMs = timeMs([&] { single = computeStats(root); });
+
+    bool same = single.height == separate.height && single.size == separate.size && single.leaves == separate.leaves &&
+                single.diameter == separate.diameter && single.balanced == separate.balanced;
+    printf("%-7s %10d %8d | height %7.1f size %7.1f leaves %7.1f diameter %7.1f balanced %9.1f = %9.1f ms | single pass %7.1f ms %s\n",
+           shape, single.size, single.height, heightMs, sizeMs, leavesMs, diameterMs, balancedMs, separateMs, singleMs,
+           same ? "(match)" : "(MISMATCH)");
+    fflush(stdout);
+}
+
+int main(int argc, char** argv) {
+    size_t n = (size_t)stod(bench::argValue(argc, argv, "--ops", "1e7"));
+    uint64_t seed = stoull(bench::argValue(argc, argv, "--seed", "42"));
+
+    printf("%-7s %10s %8s\n", "shape", "nodes", "height");
+    {
+        NodePool<t_node> pool;
+        t_node* root = newNode(&pool, 0);
+        t_node* tail = root;
+        for (size_t k = 1; k < n; k++) {
+            tail->right = newNode(&pool, (int)k);
+            tail = tail->right;
+        }
+        compare("skewed", root);
+    }
+    {
+        NodePool<t_node> pool;
+        t_node* root = nullptr;
+        for (int k : bench::makeKeys("random", n, seed)) root = bst::insertBST(root, k, &pool);
+        compare("random", root);
+    }
+    return 0;
+}
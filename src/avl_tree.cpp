@@ -1,231 +1,80 @@
+#include <cassert>
 #include <iostream>
 #include <queue>
-#include <cmath>
+#include <string>
+#include <vector>
+#ifdef HEADLESS
+#include "graphics_stub.h"  // No-op drawing for builds without BGI
+#else
 #include <graphics.h>
+#endif
+#include "avl_tree.h"
+#include "key_reader.h"
+#include "bgi_canvas.h"
+#include "tree_layout.h"
+#include "tree_redraw.h"
+#include "tree_render.h"
 
 using namespace std;
+using namespace avl;
 
-// AVL Tree node structure
-struct AVLNode {
-    int data;
-    AVLNode* left;
-    AVLNode* right;
-    int height;
-    int size;
-
-    AVLNode(int x) : data(x), left(nullptr), right(nullptr), height(1), size(1) {}
-};
-
-// Function to get the height of a node
-int getHeight(AVLNode* node) {
-    if (node == nullptr) return 0;
-    return node->height;
-}
-
-// Function to get the size of a node's subtree
-int getSize(AVLNode* node) {
-    if (node == nullptr) return 0;
-    return node->size;
-}
-
-// Function to update the height and size of a node
-void updateHeightAndSize(AVLNode* node) {
-    if (node == nullptr) return;
-    node->height = 1 + max(getHeight(node->left), getHeight(node->right));
-    node->size = 1 + getSize(node->left) + getSize(node->right);
-}
-
-// Function to get the balance factor of a node
-int getBalanceFactor(AVLNode* node) {
-    if (node == nullptr) return 0;
-    return getHeight(node->left) - getHeight(node->right);
-}
-
-// Right rotation
-AVLNode* rightRotate(AVLNode* y) {
-    AVLNode* x = y->left;
-    AVLNode* T2 = x->right;
-
-    x->right = y;
-    y->left = T2;
-
-    updateHeightAndSize(y);
-    updateHeightAndSize(x);
-
-    return x;
-}
-
-// Left rotation
-AVLNode* leftRotate(AVLNode* x) {
-    AVLNode* y = x->right;
-    AVLNode* T2 = y->left;
-
-    y->left = x;
-    x->right = T2;
-
-    updateHeightAndSize(x);
-    updateHeightAndSize(y);
-
-    return y;
-}
-
-// Insert a node into the AVL tree
-AVLNode* insert(AVLNode* node, int key) {
-    if (node == nullptr) return new AVLNode(key);
-
-    if (key < node->data)
-        node->left = insert(node->left, key);
-    else if (key > node->data)
-        node->right = insert(node->right, key);
-    else
-        return node; // Duplicate keys not allowed
-
-    updateHeightAndSize(node);
-
-    int balance = getBalanceFactor(node);
-
-    // Left Left Case
-    if (balance > 1 && key < node->left->data)
-        return rightRotate(node);
-
-    // Right Right Case
-    if (balance < -1 && key > node->right->data)
-        return leftRotate(node);
-
-    // Left Right Case
-    if (balance > 1 && key > node->left->data) {
-        node->left = leftRotate(node->left);
-        return rightRotate(node);
-    }
-
-    // Right Left Case
-    if (balance < -1 && key < node->right->data) {
-        node->right = rightRotate(node->right);
-        return leftRotate(node);
-    }
-
-    return node;
-}
-
-// Function to print the AVL tree
-void printTree(int x, int y, AVLNode* root, int level) {
-    if (!root) return;
-
-    char str[20];
-    sprintf(str, "%d (BF:%d)", root->data, getBalanceFactor(root));
-
-    int radius = 20;  // Node radius
-
-    setcolor(COLOR(144, 238, 144));  // Light Green for node
-    setfillstyle(SOLID_FILL, COLOR(144, 238, 144));
-    circle(x, y, radius);
-    floodfill(x, y, COLOR(144, 238, 144));
-
-    setcolor(WHITE);  // White for text
-    outtextxy(x - 15, y - 8, str);  // Adjusted text position
-
-    setcolor(RED);  // Red for node border
-    circle(x, y, radius);
-
-    int treeHeight = getHeight(root);
-    int offset = 300 / pow(2, level + 1);
-    int yOffset = 50;
-
-    if (root->left) {
-        setcolor(COLOR(255, 255, 0));  // Yellow for lines
-        line(x, y + radius + 5, x - offset - (level * 20), y + yOffset);
-        printTree(x - offset - (level * 20), y + yOffset, root->left, level + 1);
-    }
-    if (root->right) {
-        setcolor(COLOR(255, 255, 0));  // Yellow for lines
-        line(x, y + radius + 5, x + offset + (level * 20), y + yOffset);
-        printTree(x + offset + (level * 20), y + yOffset, root->right, level + 1);
-    }
-}
+// Node positions (see tree_layout.h)
+core::TreeLayout<AVLNode> layout;
 
+// The window, the frame being recorded and the pacing of redraws (see tree_redraw.h)
+BgiCanvas screen(800, 600, {"AVL Tree Visualizer", 250, 20, RED, 2});
+core::DisplayList frame(800, 600);
+core::Redrawer redrawer;
+core::FramePacer pacer;
+bool framePending = false;
 
 void drawNode(int x, int y, int data) {
-    setcolor(WHITE);
-    setfillstyle(SOLID_FILL, CYAN);
-    fillellipse(x, y, 20, 20);
-    
-    setbkcolor(CYAN);
-    setcolor(WHITE);
-    char num[5];
-    sprintf(num, "%d", data);
-    outtextxy(x - 10, y - 5, num);
-}
-
-// Modified function to visualize and update the AVL tree with increased gap between root's immediate children
-void visualizeAndUpdateTree(AVLNode* root, int x = 400, int y = 100, int level = 0) {
-    if (root == NULL) return;
+    frame.fillCircle(x, y, 20, CYAN);
+    frame.circle(x, y, 20, WHITE);
 
-    int baseHorizontalSpacing = 50;
-    int horizontalSpacing = (level == 0) ? 150 : baseHorizontalSpacing; // Increased spacing for root's immediate children
-    int verticalSpacing = 50;
-
-    // Recursively draw the left and right subtrees
-    if (root->left != NULL) {
-        int childX = (level == 0) ? x - horizontalSpacing : x - baseHorizontalSpacing * (level + 1);
-        line(x, y, childX, y + verticalSpacing);
-        visualizeAndUpdateTree(root->left, childX, y + verticalSpacing, level + 1);
-    }
-
-    if (root->right != NULL) {
-        int childX = (level == 0) ? x + horizontalSpacing : x + baseHorizontalSpacing * (level + 1);
-        line(x, y, childX, y + verticalSpacing);
-        visualizeAndUpdateTree(root->right, childX, y + verticalSpacing, level + 1);
-    }
-
-    // Draw the current node
-    drawNode(x, y, root->data);
+    char num[12];
+    sprintf(num, "%d", data);
+    frame.text(x - 10, y - 5, num, WHITE);
 }
 
-// Inorder traversal
-void inorder(AVLNode* root) {
-    if (root == nullptr) return;
-    inorder(root->left);
-    cout << root->data << " ";
-    inorder(root->right);
+// Function to visualize the AVL tree from its precomputed layout
+// The layout is kept up to date by the insert paths; anything else that changed the
+// node count (delete, batch or snapshot load) is laid out again here in one pass.
+void visualizeAndUpdateTree(AVLNode* root) {
+    if (layout.size() != countNodes(root)) layout.build(root);
+    core::Viewport view = core::Viewport::fit(root, 400, 100, 760, 50, 24, 150);
+
+    // Lines first, then the nodes over their ends
+    frame.clear(LIGHTGRAY);
+    layout.forEach([&](AVLNode* node, int column, int depth) {
+        int x = view.x(column), y = view.y(depth);
+        if (node->left) frame.line(x, y, view.x(layout.leftColumn(column)), view.y(depth + 1), WHITE);
+        if (node->right) frame.line(x, y, view.x(layout.rightColumn(column)), view.y(depth + 1), WHITE);
+    });
+    layout.forEach([&](AVLNode* node, int column, int depth) { drawNode(view.x(column), view.y(depth), node->data); });
+
+    redrawer.present(frame, screen);  // Repaints only what changed since the last frame
+    pacer.drawn();
+    framePending = false;
 }
 
-// Search for a node
-bool searchNode(AVLNode* root, int key) {
-    if (root == nullptr) return false;
-    if (root->data == key) return true;
-    if (key < root->data) return searchNode(root->left, key);
-    return searchNode(root->right, key);
- }
-
-// Find height of the tree
-int findHeight(AVLNode* root) {
-    if (root == nullptr) return 0;
-    return max(findHeight(root->left), findHeight(root->right)) + 1;
+// Function to redraw after an insert: right away if a frame is due, otherwise the
+// insert is coalesced into the next frame (flushFrame draws one still pending)
+void requestFrame(AVLNode* root) {
+    framePending = true;
+    if (pacer.due()) visualizeAndUpdateTree(root);
 }
 
-// Count total nodes
-int countNodes(AVLNode* root) {
-    if (root == nullptr) return 0;
-    return 1 + countNodes(root->left) + countNodes(root->right);
+void flushFrame(AVLNode* root) {
+    if (framePending) visualizeAndUpdateTree(root);
 }
 
-// Count leaf nodes
-int countLeafNodes(AVLNode* root) {
-    if (root == nullptr) return 0;
-    if (root->left == nullptr && root->right == nullptr) return 1;
-    return countLeafNodes(root->left) + countLeafNodes(root->right);
-}
+// Larger batch-loaded trees are not drawn: they would not fit the window anyway
+const int maxBatchVisualNodes = 1023;
 
-// Find diameter of the tree
-int findDiameter(AVLNode* root, int &diameter) {
-    if (root == nullptr) return 0;
-    int leftHeight = findDiameter(root->left, diameter);
-    int rightHeight = findDiameter(root->right, diameter);
-    diameter = max(diameter, leftHeight + rightHeight + 1);
-    return max(leftHeight, rightHeight) + 1;
-}
+int main(int argc, char** argv) {
+    BatchOptions batch = parseBatchOptions(argc, argv);
 
-int main() {
     int gd = DETECT, gm;
     initgraph(&gd, &gm, "");
     initwindow(800, 600, "AVL Tree Visualization");
@@ -236,37 +85,97 @@ int main() {
     setcolor(RED); // Title font color
     settextstyle(SANS_SERIF_FONT, HORIZ_DIR, 2);
     outtextxy(250, 20, "AVL Tree Visualizer");
+    settextstyle(DEFAULT_FONT, HORIZ_DIR, 1);  // Node labels use the 8x8 font
 
+    NodePool<AVLNode> pool;  // Owns every node; the tree is freed when main returns
     AVLNode* root = nullptr;
 
-    cout << "Enter 'n' at any point to stop adding nodes.\n";
-
-    while (true) {
-        string input;
-        cout << "Enter node value (or 'n' to stop): ";
-        cin >> input;
-        if (input == "n" || input == "N") {
-            break;
+    if (!batch.loadPath.empty()) {
+        SnapshotView view;
+        if (!view.open(batch.loadPath, SNAPSHOT_AVL)) {
+            cout << "Could not load snapshot " << batch.loadPath << ": " << view.error() << endl;
+            return 1;
+        }
+        root = loadAVL(view, &pool);
+        assert(checkInvariants(root));
+        cout << "Loaded " << countNodes(root) << " distinct keys from snapshot, height " << findHeight(root) << endl;
+        if (countNodes(root) <= maxBatchVisualNodes) visualizeAndUpdateTree(root);
+    } else if (batch.enabled()) {
+        KeyReadStats stats;
+        vector<int> keys;
+        bool ok = !batch.badFormat && forEachKey(batch.path, batch.format, [&](int key) {
+            if (batch.bulk) keys.push_back(key);
+            else root = insert(root, key, &pool);
+        }, &stats);
+        if (!ok) {
+            cout << "Could not read keys from " << batch.path << endl;
+            return 1;
         }
-        int val = stoi(input);
-        root = insert(root, val);
-        visualizeAndUpdateTree(root);
+        if (batch.bulk) root = bulkLoad(keys, &pool);
+        assert(checkInvariants(root));
+        cout << "Loaded " << countNodes(root) << " distinct keys, height " << findHeight(root);
+        if (stats.rejected) cout << " (" << stats.rejected << " out of range)";
+        cout << endl;
+        if (countNodes(root) <= maxBatchVisualNodes) visualizeAndUpdateTree(root);
+    } else {
+        cout << "Enter 'n' at any point to stop adding nodes.\n";
+
+        while (true) {
+            string input;
+            cout << "Enter node value (or 'n' to stop): ";
+            cin >> input;
+            if (input == "n" || input == "N") {
+                break;
+            }
+            int val = stoi(input);
+            root = insert(root, val, &pool);
+            assert(checkInvariants(root));
+            layout.inserted(root, val);
+            requestFrame(root);
+        }
+        flushFrame(root);
+    }
+
+    if (!batch.savePath.empty()) {
+        if (saveAVL(batch.savePath, root))
+            cout << "Saved snapshot to " << batch.savePath << endl;
+        else
+            cout << "Could not write snapshot " << batch.savePath << endl;
+    }
+
+    if (!batch.renderPath.empty()) {
+        core::RenderStats drawn;
+        if (core::renderToFile(root, batch.renderPath, 800, 600, core::RenderStyle(), &drawn))
+            cout << "Rendered " << drawn.nodes << " nodes and " << drawn.aggregates << " collapsed subtrees to "
+                 << batch.renderPath << endl;
+        else
+            cout << "Could not write image " << batch.renderPath << endl;
+    }
+
+    if (batch.statsOnly) {
+        printStatsJson(cout, computeStats(root));
+        closegraph();
+        return 0;
     }
 
     int choice;
     do {
         cout << "\n1. Insert a node\n2. Inorder Traversal\n3. Search for a value\n"
              << "4. Height of the tree\n5. Count total nodes\n6. Count leaf nodes\n"
-             << "7. Find the diameter of the tree\n8. Visualize Tree\n9. Exit\n"
+             << "7. Find the diameter of the tree\n8. Visualize Tree\n9. Check if the tree is balanced\n"
+             << "10. Find order of key\n11. Find k-th smallest\n12. Count values in a range\n13. Find a percentile\n"
+             << "14. Delete a value\n15. Tree statistics (JSON)\n16. Save snapshot\n17. Exit\n"
              << "Enter your choice: ";
-        cin >> choice;
+        if (!(cin >> choice)) break;  // End of input
 
         switch (choice) {
             case 1: {
                 int val;
                 cout << "Enter the value to insert: ";
                 cin >> val;
-                root = insert(root, val);
+                root = insert(root, val, &pool);
+                assert(checkInvariants(root));
+                layout.inserted(root, val);
                 visualizeAndUpdateTree(root);
                 break;
             }
@@ -292,24 +201,90 @@ int main() {
                 cout << "Total nodes in the tree: " << countNodes(root) << endl;
                 break;
             case 6:
-                cout << "Total leaf nodes in the tree: " << countLeafNodes(root) << endl;
+                cout << "Total leaf nodes in the tree: " << computeStats(root).leaves << endl;
                 break;
-            case 7: {
-                int diameter = 0;
-                findDiameter(root, diameter);
-                cout << "Diameter of the tree: " << diameter << endl;
+            case 7:
+                cout << "Diameter of the tree: " << computeStats(root).diameter << endl;
                 break;
-            }
             case 8:
                 visualizeAndUpdateTree(root);
                 break;
             case 9:
+                if (isBalanced(root))
+                    cout << "The tree is balanced.\n";
+                else
+                    cout << "The tree is not balanced.\n";
+                break;
+            case 10: {
+                int key;
+                cout << "Enter key: ";
+                cin >> key;
+                cout << "Number of elements less than " << key << " is: " << order_of_key(root, key) << endl;
+                break;
+            }
+            case 11: {
+                int k;
+                cout << "Enter k (0 for the smallest): ";
+                cin >> k;
+                AVLNode* node = find_by_order(root, k);
+                if (node)
+                    cout << "Element at order " << k << " is: " << node->data << endl;
+                else
+                    cout << "Order " << k << " is out of range.\n";
+                break;
+            }
+            case 12: {
+                int lo, hi;
+                cout << "Enter the range (low high): ";
+                cin >> lo >> hi;
+                cout << "Values in [" << lo << ", " << hi << "]: " << count_range(root, lo, hi) << endl;
+                break;
+            }
+            case 13: {
+                double p;
+                cout << "Enter the percentile (0-100): ";
+                cin >> p;
+                AVLNode* node = percentile(root, p);
+                if (node)
+                    cout << "Percentile " << p << " is: " << node->data << endl;
+                else
+                    cout << "The tree is empty.\n";
+                break;
+            }
+            case 14: {
+                int key;
+                cout << "Enter the value to delete: ";
+                cin >> key;
+                if (searchNode(root, key)) {
+                    root = erase(root, key, &pool);
+                    assert(checkInvariants(root));
+                    cout << "Value " << key << " deleted.\n";
+                    visualizeAndUpdateTree(root);
+                } else {
+                    cout << "Value " << key << " not found in the tree.\n";
+                }
+                break;
+            }
+            case 15:
+                printStatsJson(cout, computeStats(root));
+                break;
+            case 16: {
+                string path;
+                cout << "Enter the snapshot file name: ";
+                cin >> path;
+                if (saveAVL(path, root))
+                    cout << "Saved " << countNodes(root) << " nodes to " << path << ".\n";
+                else
+                    cout << "Could not write " << path << ".\n";
+                break;
+            }
+            case 17:
                 cout << "Exiting...\n";
                 break;
             default:
                 cout << "Invalid choice! Try again.\n";
         }
-    } while (choice != 9);
+    } while (choice != 17);
 
     closegraph();
     return 0;
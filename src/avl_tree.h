@@ -0,0 +1,287 @@
+#ifndef AVL_TREE_H
+#define AVL_TREE_H
+
+#include <algorithm>
+#include <vector>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <string>
+
+#include "node_pool.h"
+#include "tree_core.h"
+#include "tree_snapshot.h"
+#include "tree_stats.h"
+
+// AVL tree operations, shared by the visualizer and the benchmarks.
+namespace avl {
+
+// AVL Tree node structure: int keys with cached height and subtree size (see tree_core.h)
+using AVLNode = core::Node<int, core::SizeHeightAugment>;
+
+// Function to get the height of a node
+inline int getHeight(AVLNode* node) {
+    if (node == nullptr) return 0;
+    return node->height;
+}
+
+// Function to get the size of a node's subtree
+inline int getSize(AVLNode* node) {
+    if (node == nullptr) return 0;
+    return node->size;
+}
+
+// Function to update the height and size of a node
+inline void updateHeightAndSize(AVLNode* node) {
+    if (node == nullptr) return;
+    core::updateNode(node);
+}
+
+// Function to get the balance factor of a node
+inline int getBalanceFactor(AVLNode* node) {
+    if (node == nullptr) return 0;
+    return getHeight(node->left) - getHeight(node->right);
+}
+
+// Right rotation
+inline AVLNode* rightRotate(AVLNode* y) {
+    return core::rightRotate(y);
+}
+
+// Left rotation
+inline AVLNode* leftRotate(AVLNode* x) {
+    return core::leftRotate(x);
+}
+
+// Insert a node into the AVL tree (allocating from pool when one is given)
+inline AVLNode* insert(AVLNode* node, int key, NodePool<AVLNode>* pool = nullptr) {
+    return core::insertAVL(node, key, pool);
+}
+
+// Restore the AVL property at node after one of its subtrees shrank by one level.
+// Unlike insert, the case is picked from the child's balance factor, since after a
+// deletion there is no inserted key to compare against.
+inline AVLNode* rebalance(AVLNode* node) {
+    return core::rebalance(node);
+}
+
+// Delete a node from the AVL tree (returning it to pool when one is given)
+// Heights and sizes are recomputed on the way back up, with at most one
+// rebalance (one or two rotations) per level: O(log n).
+inline AVLNode* erase(AVLNode* node, int key, NodePool<AVLNode>* pool = nullptr) {
+    if (node == nullptr) return nullptr;  // Key not present
+
+    if (key < node->data) {
+        node->left = erase(node->left, key, pool);
+    } else if (key > node->data) {
+        node->right = erase(node->right, key, pool);
+    } else if (node->left == nullptr || node->right == nullptr) {
+        AVLNode* child = node->left ? node->left : node->right;
+        deleteNode(pool, node);
+        return child;
+    } else {
+        // Two children: take the in-order successor's key, then delete the successor
+        AVLNode* successor = node->right;
+        while (successor->left != nullptr) successor = successor->left;
+        node->data = successor->data;
+        node->right = erase(node->right, successor->data, pool);
+    }
+
+    updateHeightAndSize(node);
+    return rebalance(node);
+}
+
+// Bulk loading
+// Build a perfectly balanced AVL tree from strictly increasing keys in O(n):
+// the middle key becomes the root and each half is built the same way, with
+// height and size filled in bottom-up. Recursion depth is O(log n).
+inline AVLNode* buildBalanced(const std::vector<int>& sorted, size_t lo, size_t hi, NodePool<AVLNode>* pool) {
+    if (lo >= hi) return nullptr;
+    size_t mid = lo + (hi - lo) / 2;
+    AVLNode* node = newNode(pool, sorted[mid]);
+    node->left = buildBalanced(sorted, lo, mid, pool);
+    node->right = buildBalanced(sorted, mid + 1, hi, pool);
+    updateHeightAndSize(node);
+    return node;
+}
+
+inline AVLNode* buildBalanced(const std::vector<int>& sorted, NodePool<AVLNode>* pool = nullptr) {
+    return buildBalanced(sorted, 0, sorted.size(), pool);
+}
+
+// Build from keys in any order: sorted first when needed, duplicates dropped as in insert
+inline AVLNode* bulkLoad(std::vector<int> keys, NodePool<AVLNode>* pool = nullptr) {
+    if (!std::is_sorted(keys.begin(), keys.end())) std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    return buildBalanced(keys, pool);
+}
+
+// Collect the keys in order and release the nodes
+inline void flattenAndRelease(AVLNode* node, std::vector<int>& out, NodePool<AVLNode>* pool) {
+    if (node == nullptr) return;
+    flattenAndRelease(node->left, out, pool);
+    out.push_back(node->data);
+    AVLNode* right = node->right;
+    deleteNode(pool, node);
+    flattenAndRelease(right, out, pool);
+}
+
+// Merge a sorted batch into an existing AVL tree.
+// Small batches are inserted one by one (O(m log n)); otherwise the tree is
+// flattened, merged with the batch (dropping duplicates) and rebuilt in O(n + m).
+inline AVLNode* mergeBatch(AVLNode* root, const std::vector<int>& sortedBatch, NodePool<AVLNode>* pool = nullptr) {
+    size_t n = getSize(root), m = sortedBatch.size();
+    if (m * std::log2((double)(n + m) + 1) < n) {
+        for (int key : sortedBatch) root = insert(root, key, pool);
+        return root;
+    }
+
+    std::vector<int> existing;
+    existing.reserve(n);
+    flattenAndRelease(root, existing, pool);
+
+    std::vector<int> merged;
+    merged.reserve(n + m);
+    std::set_union(existing.begin(), existing.end(), sortedBatch.begin(), sortedBatch.end(), std::back_inserter(merged));
+    merged.erase(std::unique(merged.begin(), merged.end()), merged.end());
+    return buildBalanced(merged, pool);
+}
+
+// Snapshots (see tree_snapshot.h)
+inline bool saveAVL(const std::string& path, AVLNode* root) { return saveSnapshot(path, root, SNAPSHOT_AVL); }
+
+// Rebuild the saved tree node for node; the stored heights and sizes are reused
+// (SnapshotView::open checks them against the structure unless verify is off)
+inline AVLNode* loadAVL(const SnapshotView& view, NodePool<AVLNode>* pool = nullptr) {
+    return buildFromSnapshot(view, pool, [](AVLNode* node, const SnapshotRecord& record) {
+        node->height = record.height;
+        node->size = record.size;
+    });
+}
+
+// Inorder traversal
+inline void inorder(AVLNode* root) {
+    core::forEachInorder(root, [](AVLNode* node) { std::cout << node->data << " "; });
+}
+
+// Search for a node
+inline bool searchNode(AVLNode* root, int key) {
+    return core::searchNode(root, key);
+}
+
+// Find height of the tree (cached on the root by insert and the rotations)
+inline int findHeight(AVLNode* root) {
+    return getHeight(root);
+}
+
+// Count total nodes (cached subtree size of the root)
+inline int countNodes(AVLNode* root) {
+    return getSize(root);
+}
+
+// Check if the tree is balanced
+// Every mutation rebalances on the way back up, so with the cached heights
+// consistent only the root's balance factor needs checking.
+inline bool isBalanced(AVLNode* root) {
+    return std::abs(getBalanceFactor(root)) <= 1;
+}
+
+// Order statistics, built on the cached subtree sizes. Each is one root-to-leaf
+// descent, so O(log n).
+
+// Function to find the number of elements less than the given key (rank of key)
+inline int order_of_key(AVLNode* root, int key) {
+    return core::order_of_key(root, key);
+}
+
+// Number of elements less than or equal to the given key
+inline int count_not_greater(AVLNode* root, int key) {
+    return core::count_not_greater(root, key);
+}
+
+// Function to find the k-th smallest element (0-based, like order_of_key); nullptr if out of range
+inline AVLNode* find_by_order(AVLNode* root, int k) {
+    return core::find_by_order(root, k);
+}
+
+// Function to count the elements in the closed range [lo, hi]
+inline int count_range(AVLNode* root, int lo, int hi) {
+    if (lo > hi) return 0;
+    return count_not_greater(root, hi) - order_of_key(root, lo);
+}
+
+// Function to find the p-th percentile (nearest-rank, 0 < p <= 100); nullptr on an empty tree
+inline AVLNode* percentile(AVLNode* root, double p) {
+    int n = getSize(root);
+    if (n == 0) return nullptr;
+    int rank = (int)std::ceil(p / 100.0 * n);
+    rank = std::min(std::max(rank, 1), n);
+    return find_by_order(root, rank - 1);
+}
+
+// Ordered iteration and range scans, with no output (see core::TreeIterator):
+//   for (int key : range(root, lo, hi)) ...   visits the keys in [lo, hi] in O(log n + k)
+using iterator = core::TreeIterator<AVLNode>;
+
+inline iterator begin(AVLNode* root) {
+    return core::beginInorder(root);
+}
+
+inline iterator end(AVLNode* root) {
+    return core::endInorder(root);
+}
+
+// First key not less than key
+inline iterator lower_bound(AVLNode* root, int key) {
+    return core::lower_bound(root, key);
+}
+
+// First key greater than key
+inline iterator upper_bound(AVLNode* root, int key) {
+    return core::upper_bound(root, key);
+}
+
+inline core::TreeRange<AVLNode> range(AVLNode* root, int lo, int hi) {
+    return core::range(root, lo, hi);
+}
+
+// Count leaf nodes
+inline int countLeafNodes(AVLNode* root) {
+    return core::countLeafNodes(root);
+}
+
+// Find diameter of the tree
+inline int findDiameter(AVLNode* root, int &diameter) {
+    return core::findDiameter(root, diameter);
+}
+
+// Debug invariant checker: recomputes heights, sizes, ordering and balance from the
+// structure itself and compares them with the cached fields. O(n), so it is kept out
+// of insert and meant to be called after mutations in debug builds and tests.
+inline bool checkSubtree(AVLNode* node, long long lo, long long hi, int& height, int& size) {
+    if (node == nullptr) {
+        height = 0;
+        size = 0;
+        return true;
+    }
+    if (node->data <= lo || node->data >= hi) return false;
+
+    int leftHeight, leftSize, rightHeight, rightSize;
+    if (!checkSubtree(node->left, lo, node->data, leftHeight, leftSize)) return false;
+    if (!checkSubtree(node->right, node->data, hi, rightHeight, rightSize)) return false;
+
+    height = 1 + std::max(leftHeight, rightHeight);
+    size = 1 + leftSize + rightSize;
+    return node->height == height && node->size == size && std::abs(leftHeight - rightHeight) <= 1;
+}
+
+inline bool checkInvariants(AVLNode* root) {
+    int height, size;
+    return checkSubtree(root, (long long)INT_MIN - 1, (long long)INT_MAX + 1, height, size);
+}
+
+}  // namespace avl
+
+#endif
@@ -0,0 +1,87 @@
+#ifndef BGI_CANVAS_H
+#define BGI_CANVAS_H
+
+// The BGI window as a screen for core::Redrawer (see tree_redraw.h).
+// Clipping uses a BGI viewport, whose origin moves to the clip corner, so every call
+// is shifted back into window coordinates. clear() also draws the window heading,
+// which sits above the tree and is never inside a damaged rectangle, and then
+// restores the default 8x8 font, so labels cover exactly the bounds DisplayList
+// recorded for them.
+
+#ifdef HEADLESS
+#include "graphics_stub.h"  // No-op drawing for builds without BGI
+#else
+#include <graphics.h>
+#endif
+
+#include <cstdint>
+#include <cstring>
+
+class BgiCanvas {
+public:
+    struct Heading {
+        const char* text;
+        int x, y, color, size;
+    };
+
+    BgiCanvas(int width, int height, Heading heading) : w(width), h(height), heading(heading) {}
+
+    int width() const { return w; }
+    int height() const { return h; }
+
+    void clear(uint32_t color) {
+        setbkcolor((int)color);
+        cleardevice();
+        settextstyle(SANS_SERIF_FONT, HORIZ_DIR, heading.size);
+        setcolor(heading.color);
+        outtextxy(heading.x, heading.y, const_cast<char*>(heading.text));
+        // Back to BGI's 8x8 font, which the labels are measured in (DisplayList's default)
+        settextstyle(DEFAULT_FONT, HORIZ_DIR, 1);
+    }
+
+    void setClip(int x0, int y0, int x1, int y1) {
+        setviewport(x0, y0, x1, y1, 1);
+        originX = x0, originY = y0;
+    }
+
+    void clearClip() {
+        setviewport(0, 0, w - 1, h - 1, 1);
+        originX = originY = 0;
+    }
+
+    void fillRect(int x, int y, int width, int height, uint32_t color) {
+        setfillstyle(SOLID_FILL, (int)color);
+        bar(x - originX, y - originY, x + width - originX, y + height - originY);
+    }
+
+    void fillCircle(int cx, int cy, int r, uint32_t color) {
+        setcolor((int)color);
+        setfillstyle(SOLID_FILL, (int)color);
+        fillellipse(cx - originX, cy - originY, r, r);
+    }
+
+    void circle(int cx, int cy, int r, uint32_t color) {
+        setcolor((int)color);
+        ::circle(cx - originX, cy - originY, r);
+    }
+
+    void line(int x0, int y0, int x1, int y1, uint32_t color) {
+        setcolor((int)color);
+        ::line(x0 - originX, y0 - originY, x1 - originX, y1 - originY);
+    }
+
+    void text(int x, int y, const char* str, uint32_t color) {
+        char buffer[32];
+        std::strncpy(buffer, str, sizeof buffer - 1);
+        buffer[sizeof buffer - 1] = '\0';
+        setcolor((int)color);
+        outtextxy(x - originX, y - originY, buffer);
+    }
+
+private:
+    int w, h;
+    Heading heading;
+    int originX = 0, originY = 0;
+};
+
+#endif
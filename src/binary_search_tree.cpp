@@ -1,224 +1,169 @@
 #include <iostream>
 #include <queue>
-#include <cmath>
+#include <string>
+#include <vector>
+#ifdef HEADLESS
+#include "graphics_stub.h"  // No-op drawing for builds without BGI
+#else
 #include <graphics.h>  // Graphics library
+#endif
+#include "binary_search_tree.h"
+#include "key_reader.h"
+#include "bgi_canvas.h"
+#include "tree_layout.h"
+#include "tree_redraw.h"
+#include "tree_render.h"
 
 using namespace std;
+using namespace bst;
 
-// Tree node structure
-struct t_node {
-    int data;
-    t_node* left;
-    t_node* right;
-    int size;  // To store the size of the subtree
+// Node positions, kept in step with the tree (see tree_layout.h)
+core::TreeLayout<t_node> layout;
 
-    t_node(int x) : data(x), left(nullptr), right(nullptr), size(1) {}
-};
+// The window, the frame being recorded and the pacing of redraws (see tree_redraw.h)
+BgiCanvas screen(800, 600, {"Binary Search Tree Visualizer", 250, 20, COLOR(255, 165, 0), 3});
+core::DisplayList frame(800, 600);
+core::Redrawer redrawer;
+core::FramePacer pacer;
+bool framePending = false;
 
-// Update the size of the subtree rooted at node
-int updateSize(t_node* node) {
-    if (!node) return 0;
-    node->size = 1 + updateSize(node->left) + updateSize(node->right);
-    return node->size;
-}
-
-// BST insertion function
-t_node* insertBST(t_node* root, int key) {
-    if (!root) return new t_node(key);
-
-    if (key < root->data) {
-        root->left = insertBST(root->left, key);
-    } else {
-        root->right = insertBST(root->right, key);
-    }
-
-    updateSize(root);
-    return root;
-}
-
-// Tree traversal functions
-void Inorder(t_node* root) {
-    if (!root) return;
-    Inorder(root->left);
-    cout << root->data << " ";
-    Inorder(root->right);
-}
-
-void Preorder(t_node* root) {
-    if (!root) return;
-    cout << root->data << " ";
-    Preorder(root->left);
-    Preorder(root->right);
+// Function to record the tree into the frame from its precomputed layout
+// Edges go first so the nodes are drawn over their ends.
+void printTree(t_node* root) {
+    int radius = 20;  // Increased radius for larger nodes
+    core::Viewport view = core::Viewport::fit(root, 400, 100, 760, 100, radius + 4, 150);
+
+    int lineColor = COLOR(255, 255, 0);  // Yellow for lines
+    layout.forEach([&](t_node* node, int column, int depth) {
+        int x = view.x(column), y = view.y(depth);
+        if (node->left) frame.line(x, y + radius + 5, view.x(layout.leftColumn(column)), view.y(depth + 1), lineColor);
+        if (node->right) frame.line(x, y + radius + 5, view.x(layout.rightColumn(column)), view.y(depth + 1), lineColor);
+    });
+
+    layout.forEach([&](t_node* node, int column, int depth) {
+        int x = view.x(column), y = view.y(depth);
+        char str[12];
+        itoa(node->data, str, 10);
+
+        frame.fillCircle(x, y, radius, COLOR(144, 238, 144));  // Light Green for node
+        frame.text(x - 8, y - 8, str, WHITE);  // Adjusted text position for larger node
+        frame.circle(x, y, radius, RED);  // Red for node border
+    });
 }
 
-void Postorder(t_node* root) {
-    if (!root) return;
-    Postorder(root->left);
-    Postorder(root->right);
-    cout << root->data << " ";
+void visualizeAndUpdateTree(t_node* root) {
+    // Inserts update the layout as they happen (layout.inserted); anything else lays it out again
+    if (layout.size() != countNodes(root)) layout.build(root);
+
+    frame.clear(COLOR(0, 0, 102));  // Dark Blue background
+    printTree(root);
+    redrawer.present(frame, screen);  // Repaints only what changed since the last frame
+    pacer.drawn();
+    framePending = false;
 }
 
-void LevelOrder(t_node* root) {
-    if (!root) return;
-    queue<t_node*> q;
-    q.push(root);
-    while (!q.empty()) {
-        t_node* current = q.front();
-        cout << current->data << " ";
-        q.pop();
-        if (current->left) q.push(current->left);
-        if (current->right) q.push(current->right);
-    }
+// Function to redraw after an insert: right away if a frame is due, otherwise the
+// insert is coalesced into the next frame (flushFrame draws one still pending)
+void requestFrame(t_node* root) {
+    framePending = true;
+    if (pacer.due()) visualizeAndUpdateTree(root);
 }
 
-// Function to search a node in the BST
-bool searchNode(t_node* root, int key) {
-    if (!root) return false;
-    if (root->data == key) return true;
-    if (key < root->data) return searchNode(root->left, key);
-    return searchNode(root->right, key);
+void flushFrame(t_node* root) {
+    if (framePending) visualizeAndUpdateTree(root);
 }
 
-// Function to find the height of the BST
-int findHeight(t_node* root) {
-    if (!root) return 0;
-    int leftHeight = findHeight(root->left);
-    int rightHeight = findHeight(root->right);
-    return max(leftHeight, rightHeight) + 1;
-}
+// Larger batch-loaded trees are not drawn: they would not fit the window anyway
+const int maxBatchVisualNodes = 1023;
 
-// Function to count the total nodes in the BST
-int countNodes(t_node* root) {
-    if (!root) return 0;
-    return updateSize(root);  // Ensure size is updated
-}
+int main(int argc, char** argv) {
+    BatchOptions batch = parseBatchOptions(argc, argv);
 
-// Function to find the number of elements less than the given key
-int order_of_key(t_node* root, int key) {
-    if (!root) return 0;
+    int gd = DETECT, gm;
+    initgraph(&gd, &gm, "C:\\TURBOC3\\BGI");
+    initwindow(800, 600, "Binary Search Tree Visualization");
+    cleardevice();
 
-    int leftSize = (root->left ? root->left->size : 0);
+    NodePool<t_node> pool;  // Owns every node; the tree is freed when main returns
+    t_node* root = nullptr;
 
-    if (key <= root->data) {
-        return order_of_key(root->left, key);
+    if (!batch.loadPath.empty()) {
+        SnapshotView view;
+        if (!view.open(batch.loadPath, SNAPSHOT_BST)) {
+            cout << "Could not load snapshot " << batch.loadPath << ": " << view.error() << endl;
+            return 1;
+        }
+        root = loadBST(view, &pool);
+        cout << "Loaded " << countNodes(root) << " keys from snapshot, height " << findHeight(root) << endl;
+        if (countNodes(root) <= maxBatchVisualNodes) visualizeAndUpdateTree(root);
+    } else if (batch.enabled()) {
+        KeyReadStats stats;
+        vector<int> keys;
+        bool ok = !batch.badFormat && forEachKey(batch.path, batch.format, [&](int key) {
+            if (batch.bulk) keys.push_back(key);
+            else root = insertBST(root, key, &pool);
+        }, &stats);
+        if (!ok) {
+            cout << "Could not read keys from " << batch.path << endl;
+            return 1;
+        }
+        if (batch.bulk) root = bulkLoadBST(keys, &pool);
+        cout << "Loaded " << countNodes(root) << " keys, height " << findHeight(root);
+        if (stats.rejected) cout << " (" << stats.rejected << " out of range)";
+        cout << endl;
+        if (countNodes(root) <= maxBatchVisualNodes) visualizeAndUpdateTree(root);
     } else {
-        return leftSize + 1 + order_of_key(root->right, key);
-    }
-}
-
-// Function to count leaf nodes in the BST
-int countLeafNodes(t_node* root) {
-    if (!root) return 0;
-    if (!root->left && !root->right) return 1;
-    return countLeafNodes(root->left) + countLeafNodes(root->right);
-}
-
-// Function to check if the BST is balanced
-bool isBalanced(t_node* root) {
-    if (!root) return true;
-    int leftHeight = findHeight(root->left);
-    int rightHeight = findHeight(root->right);
-    if (abs(leftHeight - rightHeight) > 1) return false;
-    return isBalanced(root->left) && isBalanced(root->right);
-}
+        cout << "Enter root node data: ";
+        int x;
+        cin >> x;
+        root = newNode(&pool, x);
 
-// Function to find the diameter of the BST
-int findDiameter(t_node* root, int& diameter) {
-    if (!root) return 0;
-    int leftHeight = findDiameter(root->left, diameter);
-    int rightHeight = findDiameter(root->right, diameter);
-    diameter = max(diameter, leftHeight + rightHeight + 1);
-    return max(leftHeight, rightHeight) + 1;
-}
-
-void printTree(int x, int y, t_node* root, int level) {
-    if (!root) return;
-
-    char str[10];
-    itoa(root->data, str, 10);
-
-    int radius = 20;  // Increased radius for larger nodes
-
-    setcolor(COLOR(144, 238, 144));  // Light Green for node
-    setfillstyle(SOLID_FILL, COLOR(144, 238, 144));
-    circle(x, y, radius);
-    floodfill(x, y, COLOR(144, 238, 144));
-
-    setcolor(WHITE);  // White for text
-    outtextxy(x - 8, y - 8, str);  // Adjusted text position for larger node
-
-    setcolor(RED);  // Red for node border
-    circle(x, y, radius);
+        visualizeAndUpdateTree(root);
 
-    int treeHeight = findHeight(root);
-    int offset = 300 / pow(2, level + 1);
-    int yOffset = 100;
+        cout << "Enter 'n' at any point to stop adding nodes.\n";
 
-    if (root->left) {
-        setcolor(COLOR(255, 255, 0));  // Yellow for lines
-        line(x, y + radius + 5, x - offset, y + yOffset);
-        printTree(x - offset, y + yOffset, root->left, level + 1);
-    }
-    if (root->right) {
-        setcolor(COLOR(255, 255, 0));  // Yellow for lines
-        line(x, y + radius + 5, x + offset, y + yOffset);
-        printTree(x + offset, y + yOffset, root->right, level + 1);
+        while (true) {
+            string input;
+            cout << "Enter node value (or 'n' to stop): ";
+            cin >> input;
+            if (input == "n" || input == "N") {
+                break;
+            }
+            int val = stoi(input);
+            root = insertBST(root, val, &pool);
+            layout.inserted(root, val);
+            requestFrame(root);
+        }
+        flushFrame(root);
     }
-}
-
-
-
-
-void visualizeAndUpdateTree(t_node* root) {
-    cleardevice();  // Clear the current visualization
-
-    // Set background color
-    setbkcolor(COLOR(0, 0, 102));  // Dark Blue background
-    cleardevice();
-
-    // Set text style for the heading
-    settextstyle(SANS_SERIF_FONT, HORIZ_DIR, 3);
-    setcolor(COLOR(255, 165, 0));  // Orange for heading
-
-    // Display heading text at the top center
-    outtextxy(250, 20, "Binary Search Tree Visualizer");
-
-    printTree(400, 100, root, 0);  // Re-draw the tree from the root
-    delay(500);  // Small delay for visualization effect
-}
-
-int main() {
-    int gd = DETECT, gm;
-    initgraph(&gd, &gm, "C:\\TURBOC3\\BGI");
-    initwindow(800, 600, "Binary Search Tree Visualization");
-    cleardevice();
 
-    cout << "Enter root node data: ";
-    int x;
-    cin >> x;
-    t_node* root = new t_node(x);
-
-    visualizeAndUpdateTree(root);
+    if (!batch.savePath.empty()) {
+        if (saveBST(batch.savePath, root))
+            cout << "Saved snapshot to " << batch.savePath << endl;
+        else
+            cout << "Could not write snapshot " << batch.savePath << endl;
+    }
 
-    cout << "Enter 'n' at any point to stop adding nodes.\n";
+    if (!batch.renderPath.empty()) {
+        core::RenderStats drawn;
+        if (core::renderToFile(root, batch.renderPath, 800, 600, core::RenderStyle(), &drawn))
+            cout << "Rendered " << drawn.nodes << " nodes and " << drawn.aggregates << " collapsed subtrees to "
+                 << batch.renderPath << endl;
+        else
+            cout << "Could not write image " << batch.renderPath << endl;
+    }
 
-    while (true) {
-        string input;
-        cout << "Enter node value (or 'n' to stop): ";
-        cin >> input;
-        if (input == "n" || input == "N") {
-            break;
-        }
-        int val = stoi(input);
-        root = insertBST(root, val);
-        visualizeAndUpdateTree(root);
+    if (batch.statsOnly) {
+        printStatsJson(cout, computeStats(root));
+        closegraph();
+        return 0;
     }
 
     int c = 1;
     while (c) {
-        cout << "1. In-order Traversal\n2. Pre-order Traversal\n3. Post-order Traversal\n4. Level-order Traversal\n5. Search for a value\n6. Height of the tree\n7. Count total nodes\n8. Count leaf nodes\n9. Check if the tree is balanced\n10. Find the diameter of the tree\n11. Visualize Tree\n12. Find order of key\n13. Exit\nEnter your choice: ";
+        cout << "1. In-order Traversal\n2. Pre-order Traversal\n3. Post-order Traversal\n4. Level-order Traversal\n5. Search for a value\n6. Height of the tree\n7. Count total nodes\n8. Count leaf nodes\n9. Check if the tree is balanced\n10. Find the diameter of the tree\n11. Visualize Tree\n12. Find order of key\n13. Delete a value\n14. Tree statistics (JSON)\n15. Save snapshot\n16. Exit\nEnter your choice: ";
         int choice;
-        cin >> choice;
+        if (!(cin >> choice)) break;  // End of input
 
         switch (choice) {
             case 1:
@@ -248,13 +193,13 @@ int main() {
                 break;
             }
             case 6:
-                cout << "Height of the tree: " << findHeight(root) << endl;
+                cout << "Height of the tree: " << computeStats(root).height << endl;
                 break;
             case 7:
                 cout << "Total nodes in the tree: " << countNodes(root) << endl;
                 break;
             case 8:
-                cout << "Total leaf nodes in the tree: " << countLeafNodes(root) << endl;
+                cout << "Total leaf nodes in the tree: " << computeStats(root).leaves << endl;
                 break;
             case 9:
                 if (isBalanced(root))
@@ -262,12 +207,9 @@ int main() {
                 else
                     cout << "The tree is not balanced.\n";
                 break;
-            case 10: {
-                int diameter = 0;
-                findDiameter(root, diameter);
-                cout << "Diameter of the tree: " << diameter << endl;
+            case 10:
+                cout << "Diameter of the tree: " << computeStats(root).diameter << endl;
                 break;
-            }
             case 11:
                 visualizeAndUpdateTree(root);
                 break;
@@ -278,7 +220,33 @@ int main() {
                 cout << "Order of key " << key << " is: " << order_of_key(root, key) << endl;
                 break;
             }
-            case 13:
+            case 13: {
+                cout << "Enter the value to delete: ";
+                int key;
+                cin >> key;
+                if (searchNode(root, key)) {
+                    root = eraseBST(root, key, &pool);
+                    cout << "Node " << key << " deleted.\n";
+                    visualizeAndUpdateTree(root);
+                } else {
+                    cout << "Node " << key << " not found in the tree.\n";
+                }
+                break;
+            }
+            case 14:
+                printStatsJson(cout, computeStats(root));
+                break;
+            case 15: {
+                cout << "Enter the snapshot file name: ";
+                string path;
+                cin >> path;
+                if (saveBST(path, root))
+                    cout << "Saved " << countNodes(root) << " nodes to " << path << ".\n";
+                else
+                    cout << "Could not write " << path << ".\n";
+                break;
+            }
+            case 16:
                 c = 0;
                 break;
             default:
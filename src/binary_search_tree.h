@@ -0,0 +1,226 @@
+#ifndef BINARY_SEARCH_TREE_H
+#define BINARY_SEARCH_TREE_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "node_pool.h"
+#include "tree_core.h"
+#include "tree_snapshot.h"
+#include "tree_stats.h"
+
+// Binary search tree operations, shared by the visualizer and the benchmarks.
+namespace bst {
+
+// Tree node structure: int keys with a cached subtree size (see tree_core.h)
+using t_node = core::Node<int, core::SizeAugment>;
+
+// Update the size of the subtree rooted at node
+inline int updateSize(t_node* node) {
+    core::updateAugment(node);
+    return core::getSize(node);
+}
+
+// BST insertion function
+// Every key is inserted (duplicates go right), so each node on the descent
+// path gains exactly one descendant; sizes are bumped on the way down in O(h).
+// Nodes come from pool when one is given.
+inline t_node* insertBST(t_node* root, int key, NodePool<t_node>* pool = nullptr) {
+    return core::insertBST(root, key, pool);
+}
+
+// Tree traversal functions
+// All traversals keep their pending nodes on a heap-allocated stack instead of
+// the call stack, so their depth is bounded only by memory.
+inline void Inorder(t_node* root) {
+    core::forEachInorder(root, [](t_node* node) { std::cout << node->data << " "; });
+}
+
+inline void Preorder(t_node* root) {
+    core::forEachPreorder(root, [](t_node* node) { std::cout << node->data << " "; });
+}
+
+inline void Postorder(t_node* root) {
+    core::forEachPostorder(root, [](t_node* node) { std::cout << node->data << " "; });
+}
+
+inline void LevelOrder(t_node* root) {
+    core::forEachLevelOrder(root, [](t_node* node) { std::cout << node->data << " "; });
+}
+
+// Function to search a node in the BST
+inline bool searchNode(t_node* root, int key) {
+    return core::searchNode(root, key);
+}
+
+// BST deletion function
+// Removes one occurrence of key (the first met on the search path). Subtree sizes
+// are decremented on the way down once the key is known to be present; a node with
+// two children takes its in-order successor's value and the successor is unlinked.
+inline t_node* eraseBST(t_node* root, int key, NodePool<t_node>* pool = nullptr) {
+    if (!searchNode(root, key)) return root;
+
+    t_node** link = &root;
+    while ((*link)->data != key) {
+        (*link)->size--;
+        link = (key < (*link)->data) ? &(*link)->left : &(*link)->right;
+    }
+
+    t_node* target = *link;
+    if (target->left && target->right) {
+        target->size--;
+        t_node** successorLink = &target->right;
+        while ((*successorLink)->left) {
+            (*successorLink)->size--;
+            successorLink = &(*successorLink)->left;
+        }
+        t_node* successor = *successorLink;
+        target->data = successor->data;
+        *successorLink = successor->right;
+        deleteNode(pool, successor);
+    } else {
+        *link = target->left ? target->left : target->right;
+        deleteNode(pool, target);
+    }
+    return root;
+}
+
+// Bulk loading
+// Build a balanced BST from sorted keys in O(n). Each node takes the middle key of
+// its range (moved left past equal keys, so duplicates still sit in the right
+// subtree as insertBST expects) and its size is simply the range length. Ranges
+// wait on an explicit stack, since long runs of duplicates can make the tree deep.
+inline t_node* buildBalancedBST(const std::vector<int>& sorted, NodePool<t_node>* pool = nullptr) {
+    struct Range {
+        size_t lo, hi;
+        t_node** link;
+    };
+    t_node* root = nullptr;
+    std::vector<Range> stack{{0, sorted.size(), &root}};
+    while (!stack.empty()) {
+        Range range = stack.back();
+        stack.pop_back();
+        if (range.lo >= range.hi) continue;
+        size_t mid = range.lo + (range.hi - range.lo) / 2;
+        while (mid > range.lo && sorted[mid - 1] == sorted[mid]) mid--;
+        t_node* node = newNode(pool, sorted[mid]);
+        node->size = (int)(range.hi - range.lo);
+        *range.link = node;
+        stack.push_back({range.lo, mid, &node->left});
+        stack.push_back({mid + 1, range.hi, &node->right});
+    }
+    return root;
+}
+
+// Build a balanced BST from keys in any order (sorted first when needed)
+inline t_node* bulkLoadBST(std::vector<int> keys, NodePool<t_node>* pool = nullptr) {
+    if (!std::is_sorted(keys.begin(), keys.end())) std::sort(keys.begin(), keys.end());
+    return buildBalancedBST(keys, pool);
+}
+
+// Merge a sorted batch into an existing BST.
+// Small batches are inserted one by one (O(m log n) on a balanced tree); otherwise
+// the tree is flattened, merged with the batch and rebuilt balanced in O(n + m).
+inline t_node* mergeBatchBST(t_node* root, const std::vector<int>& sortedBatch, NodePool<t_node>* pool = nullptr) {
+    size_t n = root ? root->size : 0, m = sortedBatch.size();
+    if (m * std::log2((double)(n + m) + 1) < n) {
+        for (int key : sortedBatch) root = insertBST(root, key, pool);
+        return root;
+    }
+
+    std::vector<int> existing;
+    existing.reserve(n);
+    std::vector<t_node*> stack;
+    t_node* current = root;
+    while (current || !stack.empty()) {
+        while (current) {
+            stack.push_back(current);
+            current = current->left;
+        }
+        current = stack.back();
+        stack.pop_back();
+        existing.push_back(current->data);
+        t_node* right = current->right;
+        deleteNode(pool, current);  // Left subtree is done, so the node can go now
+        current = right;
+    }
+
+    std::vector<int> merged(n + m);
+    std::merge(existing.begin(), existing.end(), sortedBatch.begin(), sortedBatch.end(), merged.begin());
+    return buildBalancedBST(merged, pool);
+}
+
+// Snapshots (see tree_snapshot.h)
+inline bool saveBST(const std::string& path, t_node* root) { return saveSnapshot(path, root, SNAPSHOT_BST); }
+
+// Rebuild the saved tree node for node, keeping its shape and subtree sizes
+inline t_node* loadBST(const SnapshotView& view, NodePool<t_node>* pool = nullptr) {
+    return buildFromSnapshot(view, pool, [](t_node* node, const SnapshotRecord& record) { node->size = record.size; });
+}
+
+// Function to find the height of the BST
+inline int findHeight(t_node* root) {
+    return core::findHeight(root);
+}
+
+// Function to count the total nodes in the BST
+inline int countNodes(t_node* root) {
+    if (!root) return 0;
+    return root->size;  // Kept up to date by insertBST
+}
+
+// Function to find the number of elements less than the given key
+inline int order_of_key(t_node* root, int key) {
+    return core::order_of_key(root, key);
+}
+
+// Ordered iteration and range scans, with no output (see core::TreeIterator):
+//   for (int key : range(root, lo, hi)) ...   visits the keys in [lo, hi] in O(log n + k)
+using iterator = core::TreeIterator<t_node>;
+
+inline iterator begin(t_node* root) {
+    return core::beginInorder(root);
+}
+
+inline iterator end(t_node* root) {
+    return core::endInorder(root);
+}
+
+// First key not less than key
+inline iterator lower_bound(t_node* root, int key) {
+    return core::lower_bound(root, key);
+}
+
+// First key greater than key
+inline iterator upper_bound(t_node* root, int key) {
+    return core::upper_bound(root, key);
+}
+
+inline core::TreeRange<t_node> range(t_node* root, int lo, int hi) {
+    return core::range(root, lo, hi);
+}
+
+// Function to count leaf nodes in the BST
+inline int countLeafNodes(t_node* root) {
+    return core::countLeafNodes(root);
+}
+
+// Function to check if the BST is balanced
+// One post-order pass (computeStats) instead of a height walk per node.
+inline bool isBalanced(t_node* root) {
+    return computeStats(root).balanced;
+}
+
+// Function to find the diameter of the BST
+inline int findDiameter(t_node* root, int& diameter) {
+    return core::findDiameter(root, diameter);
+}
+
+}  // namespace bst
+
+#endif
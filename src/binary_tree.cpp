@@ -1,182 +1,119 @@
 #include <iostream>
 #include <queue>
-#include <cmath>
+#include <string>
+#ifdef HEADLESS
+#include "graphics_stub.h"  // No-op drawing for builds without BGI
+#else
 #include <graphics.h>  // Graphics library
+#endif
+#include "binary_tree.h"
+#include "implicit_tree.h"
+#include "key_index.h"
+#include "key_reader.h"
+#include "bgi_canvas.h"
+#include "tree_layout.h"
+#include "tree_redraw.h"
+#include "tree_render.h"
+#include "node_pool.h"
 
 using namespace std;
-
-// Tree node structure
-struct t_node {
-    int data;
-    t_node* left;
-    t_node* right;
-    int size;  // To store the size of the subtree
-
-    t_node(int x) : data(x), left(nullptr), right(nullptr), size(1) {}
-};
-
-// Update the size of the subtree rooted at node
-int updateSize(t_node* node) {
-    if (!node) return 0;
-    node->size = 1 + updateSize(node->left) + updateSize(node->right);
-    return node->size;
-}
-
-// Tree traversal functions
-void Inorder(t_node* root) {
-    if (!root) return;
-    Inorder(root->left);
-    cout << root->data << " ";
-    Inorder(root->right);
-}
-
-void Preorder(t_node* root) {
-    if (!root) return;
-    cout << root->data << " ";
-    Preorder(root->left);
-    Preorder(root->right);
-}
-
-void Postorder(t_node* root) {
-    if (!root) return;
-    Postorder(root->left);
-    Postorder(root->right);
-    cout << root->data << " ";
-}
-
-void LevelOrder(t_node* root) {
-    if (!root) return;
-    queue<t_node*> q;
-    q.push(root);
-    while (!q.empty()) {
-        t_node* current = q.front();
-        cout << current->data << " ";
-        q.pop();
-        if (current->left) q.push(current->left);
-        if (current->right) q.push(current->right);
-    }
-}
-
-// Function to search a node in the binary tree
-bool searchNode(t_node* root, int key) {
-    if (!root) return false;
-    if (root->data == key) return true;
-    return searchNode(root->left, key) || searchNode(root->right, key);
-}
-
-// Function to find the height of the binary tree
-int findHeight(t_node* root) {
-    if (!root) return 0;
-    int leftHeight = findHeight(root->left);
-    int rightHeight = findHeight(root->right);
-    return max(leftHeight, rightHeight) + 1;
-}
-
-// Function to count the total nodes in the binary tree
-int countNodes(t_node* root) {
-    if (!root) return 0;
-    return updateSize(root);  // Ensure size is updated
+using namespace bt;
+
+// Node positions (see tree_layout.h)
+core::TreeLayout<t_node> layout;
+
+// The window, the frame being recorded and the pacing of redraws (see tree_redraw.h)
+BgiCanvas screen(800, 600, {"Binary Tree Visualizer", 250, 20, MAGENTA, 3});
+core::DisplayList frame(800, 600);
+core::Redrawer redrawer;
+core::FramePacer pacer;
+bool framePending = false;
+
+// Function to record the tree into the frame from its precomputed layout
+// Edges go first so the nodes are drawn over their ends.
+void printTree(t_node* root) {
+    int radius = 15;
+    core::Viewport view = core::Viewport::fit(root, 300, 100, 560, 100, radius + 4, 150);
+
+    // Connecting lines with different colors for left and right children
+    layout.forEach([&](t_node* node, int column, int depth) {
+        int x = view.x(column), y = view.y(depth);
+        if (node->left) frame.line(x, y + 20, view.x(layout.leftColumn(column)), view.y(depth + 1), YELLOW);
+        if (node->right) frame.line(x, y + 20, view.x(layout.rightColumn(column)), view.y(depth + 1), WHITE);
+    });
+
+    layout.forEach([&](t_node* node, int column, int depth) {
+        int x = view.x(column), y = view.y(depth);
+        char str[12];
+        itoa(node->data, str, 10);
+
+        // Set the color for the node based on its level in the tree
+        int nodeColor = (depth % 3 == 0) ? LIGHTBLUE : (depth % 3 == 1) ? LIGHTGREEN : LIGHTCYAN;
+        int textColor = BLACK; // White for root node
+
+        frame.fillCircle(x, y, radius, nodeColor);  // The circle representing the node
+        frame.text(x - 5, y - 5, str, textColor);  // Display node data inside the circle
+        frame.circle(x, y, radius, RED);  // Node border
+    });
 }
 
-// Function to find the number of elements less than the given key
-int order_of_key(t_node* root, int key) {
-    if (!root) return 0;
-
-    int leftSize = (root->left ? root->left->size : 0);
-
-    if (key <= root->data) {
-        return order_of_key(root->left, key);
-    } else {
-        return leftSize + 1 + order_of_key(root->right, key);
-    }
-}
-
-// Function to count leaf nodes in the binary tree
-int countLeafNodes(t_node* root) {
-    if (!root) return 0;
-    if (!root->left && !root->right) return 1;
-    return countLeafNodes(root->left) + countLeafNodes(root->right);
+void visualizeAndUpdateTree(t_node* root) {
+    // Visualize the tree. Children are attached anywhere in the unordered tree, so
+    // there is no key to find an insert by: refresh the sizes and lay out again, O(n).
+    updateSize(root);
+    layout.build(root);
+
+    frame.clear(LIGHTGRAY);
+    printTree(root);
+    redrawer.present(frame, screen);  // Repaints only what changed since the last frame
+    pacer.drawn();
+    framePending = false;
 }
 
-// Function to check if the tree is balanced
-bool isBalanced(t_node* root) {
-    if (!root) return true;
-    int leftHeight = findHeight(root->left);
-    int rightHeight = findHeight(root->right);
-    if (abs(leftHeight - rightHeight) > 1) return false;
-    return isBalanced(root->left) && isBalanced(root->right);
+// Function to redraw after a node is added: right away if a frame is due, otherwise
+// the change is coalesced into the next frame (flushFrame draws one still pending)
+void requestFrame(t_node* root) {
+    framePending = true;
+    if (pacer.due()) visualizeAndUpdateTree(root);
 }
 
-// Function to find the diameter of the binary tree
-int findDiameter(t_node* root, int& diameter) {
-    if (!root) return 0;
-    int leftHeight = findDiameter(root->left, diameter);
-    int rightHeight = findDiameter(root->right, diameter);
-    diameter = max(diameter, leftHeight + rightHeight + 1);
-    return max(leftHeight, rightHeight) + 1;
+void flushFrame(t_node* root) {
+    if (framePending) visualizeAndUpdateTree(root);
 }
 
-void printTree(int x, int y, t_node* root, int level) {
-    if (!root) return;
-
-    char str[10];
-    itoa(root->data, str, 10);
-
-    // Set the color for the node based on its level in the tree
-    int nodeColor = (level % 3 == 0) ? LIGHTBLUE : (level % 3 == 1) ? LIGHTGREEN : LIGHTCYAN;
-    int textColor = BLACK; // White for root node
-
-    setcolor(nodeColor);
-    setfillstyle(SOLID_FILL, nodeColor);
-    circle(x, y, 15);  // Draw the circle representing the node
-    floodfill(x, y, nodeColor);  // Fill the node with the color
-
-    // Draw the text inside the node
-    setcolor(textColor);  // Text color contrast, white for the root node
-    outtextxy(x - 5, y - 5, str);  // Display node data inside the circle
-
-    // Drawing connecting lines with different color
-    setcolor(RED);  // Line color
-    circle(x, y, 15);
-
-    int treeHeight = findHeight(root);
-    int offset = 300 / pow(2, level + 1);
-    int yOffset = 100;
-
-    // Connect and draw left and right child nodes
-    if (root->left) {
-        setcolor(YELLOW);  // Set color for the left child line
-        line(x, y + 20, x - offset, y + yOffset);
-        printTree(x - offset, y + yOffset, root->left, level + 1);
-    }
-    if (root->right) {
-        setcolor(WHITE);  // Set color for the right child line
-        line(x, y + 20, x + offset, y + yOffset);
-        printTree(x + offset, y + yOffset, root->right, level + 1);
-    }
-}
+// Larger batch-loaded trees are not drawn: they would not fit the window anyway
+const int maxBatchVisualNodes = 1023;
 
-void visualizeAndUpdateTree(t_node* root) {
-    cleardevice();  // Clear the current visualization
-    
-    // Set background color
-    setbkcolor(LIGHTGRAY);  
-    cleardevice();  // Reapply the background color after clearing the screen
-
-    // Set text style for the heading
-    settextstyle(SANS_SERIF_FONT, HORIZ_DIR, 3);
-
-    // Display heading text with a vibrant color
-    setcolor(MAGENTA);
-    outtextxy(250, 20, "Binary Tree Visualizer");
-
-    // Visualize the tree
-    printTree(300, 100, root, 0);
-    delay(200);  // Reduced delay for faster visualization
+// Build the tree from a batch of keys in level order, the same order the
+// interactive prompts use: the root first, then the left and right child of
+// each node in turn, with -1 meaning "no child"
+bool loadLevelOrderBatch(const BatchOptions& batch, NodePool<t_node>& pool, t_node*& root, KeyReadStats& stats) {
+    queue<t_node*> q;
+    t_node* parent = nullptr;
+    bool leftNext = true;
+    return forEachKey(batch.path, batch.format, [&](int key) {
+        if (!root) {
+            root = newNode(&pool, key);
+            q.push(root);
+            return;
+        }
+        if (leftNext) {
+            if (q.empty()) return;  // No open slots left (every remaining child was -1)
+            parent = q.front();
+            q.pop();
+        }
+        if (key != -1) {
+            t_node* child = newNode(&pool, key);
+            (leftNext ? parent->left : parent->right) = child;
+            q.push(child);
+        }
+        leftNext = !leftNext;
+    }, &stats);
 }
 
+int main(int argc, char** argv) {
+    BatchOptions batch = parseBatchOptions(argc, argv);
 
-int main() {
     int gd = DETECT, gm;
     initgraph(&gd, &gm, "C:\\TURBOC3\\BGI");
     initwindow(800, 600, "Binary Tree Visualization");
@@ -185,56 +122,108 @@ int main() {
     setbkcolor(LIGHTGRAY);  
     cleardevice();  // Apply the background color
 
-    cout << "Enter root node data: ";
-    int x;
-    cin >> x;
-    t_node* root = new t_node(x);
+    NodePool<t_node> pool;  // Owns every node; the tree is freed when main returns
+    t_node* root = nullptr;
 
-    queue<t_node*> q;
-    q.push(root);
+    ImplicitTree implicit;  // With --implicit: the same tree as an array, for the scans it answers
+    bool useImplicit = false;
 
-    visualizeAndUpdateTree(root);
+    KeyIndex index(batch.bloom);  // With --index: key -> node, kept up to date as nodes are added
 
-    cout << "Enter 'n' at any point to stop adding nodes.\n";
+    if (batch.enabled()) {
+        KeyReadStats stats;
+        bool ok;
+        if (batch.implicit) {
+            ok = !batch.badFormat && forEachKey(batch.path, batch.format, [&](int key) { implicit.push(key); }, &stats);
+            if (ok && implicit.gaveUp()) {
+                cout << "The keys do not fit an implicit array (too sparse, or a key equal to " << ImplicitTree::absent
+                     << "); load them without --implicit" << endl;
+                return 1;
+            }
+            root = implicit.toPointerTree(&pool);
+            useImplicit = true;
+        } else {
+            ok = !batch.badFormat && loadLevelOrderBatch(batch, pool, root, stats);
+        }
+        if (!ok) {
+            cout << "Could not read keys from " << batch.path << endl;
+            return 1;
+        }
+        if (batch.index) index.build(root);
+        int nodes = root ? updateSize(root) : 0;
+        cout << "Loaded " << nodes << " nodes from " << stats.keys << " keys";
+        if (stats.rejected) cout << " (" << stats.rejected << " out of range)";
+        cout << endl;
+        if (nodes <= maxBatchVisualNodes) visualizeAndUpdateTree(root);
+    } else {
+        cout << "Enter root node data: ";
+        int x;
+        cin >> x;
+        root = newNode(&pool, x);
+        if (batch.index) index.add(root);
 
-    while (!q.empty()) {
-        t_node* temp = q.front();
-        q.pop();
+        queue<t_node*> q;
+        q.push(root);
 
-        string input;
+        visualizeAndUpdateTree(root);
 
-        cout << "Enter left child of " << temp->data << " (or 'n' to stop): ";
-        cin >> input;
-        if (input == "n" || input == "N") {
-            break;
-        }
-        int lc = stoi(input);
-        if (lc != -1) {
-            temp->left = new t_node(lc);
-            q.push(temp->left);
-            updateSize(root);
-            visualizeAndUpdateTree(root);
-        }
+        cout << "Enter 'n' at any point to stop adding nodes.\n";
 
-        cout << "Enter right child of " << temp->data << " (or 'n' to stop): ";
-        cin >> input;
-        if (input == "n" || input == "N") {
-            break;
-        }
-        int rc = stoi(input);
-        if (rc != -1) {
-            temp->right = new t_node(rc);
-            q.push(temp->right);
-            updateSize(root);
-            visualizeAndUpdateTree(root);
+        while (!q.empty()) {
+            t_node* temp = q.front();
+            q.pop();
+
+            string input;
+
+            cout << "Enter left child of " << temp->data << " (or 'n' to stop): ";
+            cin >> input;
+            if (input == "n" || input == "N") {
+                break;
+            }
+            int lc = stoi(input);
+            if (lc != -1) {
+                temp->left = newNode(&pool, lc);
+                if (batch.index) index.add(temp->left);
+                q.push(temp->left);
+                requestFrame(root);
+            }
+
+            cout << "Enter right child of " << temp->data << " (or 'n' to stop): ";
+            cin >> input;
+            if (input == "n" || input == "N") {
+                break;
+            }
+            int rc = stoi(input);
+            if (rc != -1) {
+                temp->right = newNode(&pool, rc);
+                if (batch.index) index.add(temp->right);
+                q.push(temp->right);
+                requestFrame(root);
+            }
         }
+        flushFrame(root);
+    }
+
+    if (!batch.renderPath.empty()) {
+        core::RenderStats drawn;
+        if (core::renderToFile(root, batch.renderPath, 800, 600, core::RenderStyle(), &drawn))
+            cout << "Rendered " << drawn.nodes << " nodes and " << drawn.aggregates << " collapsed subtrees to "
+                 << batch.renderPath << endl;
+        else
+            cout << "Could not write image " << batch.renderPath << endl;
+    }
+
+    if (batch.statsOnly) {
+        printStatsJson(cout, computeStats(root));
+        closegraph();
+        return 0;
     }
 
     int c = 1;
     while (c) {
-        cout << "1. In-order Traversal\n2. Pre-order Traversal\n3. Post-order Traversal\n4. Level-order Traversal\n5. Search for a value\n6. Height of the tree\n7. Count total nodes\n8. Count leaf nodes\n9. Check if the tree is balanced\n10. Find the diameter of the tree\n11. Visualize Tree\n12. Find order of key\n13. Exit\nEnter your choice: ";
+        cout << "1. In-order Traversal\n2. Pre-order Traversal\n3. Post-order Traversal\n4. Level-order Traversal\n5. Search for a value\n6. Height of the tree\n7. Count total nodes\n8. Count leaf nodes\n9. Check if the tree is balanced\n10. Find the diameter of the tree\n11. Visualize Tree\n12. Find order of key\n13. Tree statistics (JSON)\n14. Exit\nEnter your choice: ";
         int choice;
-        cin >> choice;
+        if (!(cin >> choice)) break;  // End of input
 
         switch (choice) {
             case 1:
@@ -251,26 +240,28 @@ int main() {
                 break;
             case 4:
                 cout << "Level-order Traversal: ";
-                LevelOrder(root);
+                if (useImplicit) LevelOrder(implicit);  // One scan of the array
+                else LevelOrder(root);
                 break;
             case 5: {
                 cout << "Enter the node to search: ";
                 int key;
                 cin >> key;
-                if (searchNode(root, key))
+                if (batch.index ? index.contains(key) : searchNode(root, key))
                     cout << "Node " << key << " found in the tree.\n";
                 else
                     cout << "Node " << key << " not found in the tree.\n";
                 break;
             }
             case 6:
-                cout << "Height of the tree: " << findHeight(root) << endl;
+                cout << "Height of the tree: " << (useImplicit ? implicit.findHeight() : computeStats(root).height) << endl;
                 break;
             case 7:
                 cout << "Total nodes in the tree: " << countNodes(root) << endl;
                 break;
             case 8:
-                cout << "Total leaf nodes in the tree: " << countLeafNodes(root) << endl;
+                cout << "Total leaf nodes in the tree: "
+                     << (useImplicit ? implicit.countLeafNodes() : computeStats(root).leaves) << endl;
                 break;
             case 9:
                 if (isBalanced(root))
@@ -278,27 +269,28 @@ int main() {
                 else
                     cout << "The tree is not balanced.\n";
                 break;
-            case 10: {
-                int diameter = 0;
-                findDiameter(root, diameter);
-                cout << "Diameter of the tree: " << diameter << endl;
+            case 10:
+                cout << "Diameter of the tree: " << computeStats(root).diameter << endl;
                 break;
-            }
             case 11:
-                cleardevice();
-                printTree(300, 100, root, 0);
+                redrawer.invalidate();  // Draw the whole tree, on a clean screen
+                visualizeAndUpdateTree(root);
                 getch();
                 cleardevice();
+                redrawer.invalidate();  // The screen no longer shows the last frame
                 break;
             case 12: {
                 cout << "Enter the key to find order: ";
                 int key;
                 cin >> key;
-                int order = order_of_key(root, key);
+                int order = batch.index ? index.order_of_key(key) : order_of_key(root, key);
                 cout << "Number of elements less than " << key << " is: " << order << endl;
                 break;
             }
             case 13:
+                printStatsJson(cout, computeStats(root));
+                break;
+            case 14:
                 c = 0;
                 break;
             default:
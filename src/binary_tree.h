@@ -0,0 +1,82 @@
+#ifndef BINARY_TREE_H
+#define BINARY_TREE_H
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+
+#include "tree_core.h"
+#include "tree_stats.h"
+
+// Plain (unordered) binary tree operations, shared by the visualizer and the benchmarks.
+namespace bt {
+
+// Tree node structure: int keys with a cached subtree size (see tree_core.h)
+using t_node = core::Node<int, core::SizeAugment>;
+
+// Update the size of the subtree rooted at node
+inline int updateSize(t_node* node) {
+    core::updateAugment(node);
+    return core::getSize(node);
+}
+
+// Tree traversal functions
+inline void Inorder(t_node* root) {
+    core::forEachInorder(root, [](t_node* node) { std::cout << node->data << " "; });
+}
+
+inline void Preorder(t_node* root) {
+    core::forEachPreorder(root, [](t_node* node) { std::cout << node->data << " "; });
+}
+
+inline void Postorder(t_node* root) {
+    core::forEachPostorder(root, [](t_node* node) { std::cout << node->data << " "; });
+}
+
+inline void LevelOrder(t_node* root) {
+    core::forEachLevelOrder(root, [](t_node* node) { std::cout << node->data << " "; });
+}
+
+// Function to search a node in the binary tree
+inline bool searchNode(t_node* root, int key) {
+    return core::searchUnordered(root, key);
+}
+
+// Function to find the height of the binary tree
+inline int findHeight(t_node* root) {
+    return core::findHeight(root);
+}
+
+// Function to count the total nodes in the binary tree
+inline int countNodes(t_node* root) {
+    if (!root) return 0;
+    return updateSize(root);  // Ensure size is updated
+}
+
+// Function to find the number of elements less than the given key
+// The tree has no key order, so every node is compared; KeyIndex (key_index.h) answers it without a walk.
+inline int order_of_key(t_node* root, int key) {
+    int less = 0;
+    core::forEachPreorder(root, [&](t_node* node) { less += node->data < key; });
+    return less;
+}
+
+// Function to count leaf nodes in the binary tree
+inline int countLeafNodes(t_node* root) {
+    return core::countLeafNodes(root);
+}
+
+// Function to check if the tree is balanced
+// One post-order pass (computeStats) instead of a height walk per node.
+inline bool isBalanced(t_node* root) {
+    return computeStats(root).balanced;
+}
+
+// Function to find the diameter of the binary tree
+inline int findDiameter(t_node* root, int& diameter) {
+    return core::findDiameter(root, diameter);
+}
+
+}  // namespace bt
+
+#endif
@@ -0,0 +1,232 @@
+#ifndef BTREE_H
+#define BTREE_H
+
+// Wide-node ordered tree (a B-tree with up to 31 keys per node).
+// Each node keeps its keys sorted in a 32-slot, cache-line aligned array padded with
+// INT_MAX, so the position of a key inside a node is the number of slots less than it,
+// computed with whole-array SIMD compares (AVX2: 4 x 8 lanes, SSE2: 8 x 4 lanes) and
+// no branches. A search touches one node per level, about log32(n) nodes instead of
+// log2(n). Internal nodes also cache the key count of each child subtree for
+// order_of_key. Duplicate keys are ignored, as in the AVL tree.
+
+#include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "node_pool.h"
+
+namespace btree {
+
+const int SLOTS = 32;             // Key slots per node, the last one always padding
+const int MAX_KEYS = SLOTS - 1;   // A full node splits into two of MAX_KEYS / 2 around its median
+
+// Leaf node; internal nodes extend it with child links
+struct alignas(64) BTreeNode {
+    int keys[SLOTS];
+    int count;
+    bool leaf;
+};
+
+struct alignas(64) BTreeInternal : BTreeNode {
+    BTreeNode* children[SLOTS];
+    int childSize[SLOTS];  // Keys in each child's subtree
+};
+
+// Number of keys in a node's slot array that are less than key
+inline int rankInNode(const int* keys, int key) {
+#if defined(__AVX2__)
+    __m256i target = _mm256_set1_epi32(key);
+    int less = 0;
+    for (int i = 0; i < SLOTS; i += 8) {
+        __m256i block = _mm256_load_si256(reinterpret_cast<const __m256i*>(keys + i));
+        less += __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(target, block))));
+    }
+    return less;
+#elif defined(__SSE2__)
+    __m128i target = _mm_set1_epi32(key);
+    int less = 0;
+    for (int i = 0; i < SLOTS; i += 4) {
+        __m128i block = _mm_load_si128(reinterpret_cast<const __m128i*>(keys + i));
+        less += __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(target, block))));
+    }
+    return less;
+#else
+    int less = 0;
+    for (int i = 0; i < SLOTS; i++) less += keys[i] < key;
+    return less;
+#endif
+}
+
+class BTree {
+public:
+    BTree() : root(nullptr), total(0), levels(0) {}
+    BTree(const BTree&) = delete;
+    BTree& operator=(const BTree&) = delete;
+
+    // Insert a key; returns false (and leaves the tree unchanged) for a duplicate.
+    // Full nodes are split on the way down, so the descent never has to back up.
+    bool insert(int key) {
+        if (searchNode(key)) return false;
+        if (!root) {
+            root = newLeaf();
+            levels = 1;
+        }
+        if (root->count == MAX_KEYS) {
+            BTreeInternal* top = newInternal();
+            top->children[0] = root;
+            top->childSize[0] = total;
+            splitChild(top, 0);
+            root = top;
+            levels++;
+        }
+
+        BTreeNode* node = root;
+        while (!node->leaf) {
+            BTreeInternal* parent = static_cast<BTreeInternal*>(node);
+            int i = rankInNode(parent->keys, key);
+            if (parent->children[i]->count == MAX_KEYS) {
+                splitChild(parent, i);
+                if (key > parent->keys[i]) i++;
+            }
+            parent->childSize[i]++;
+            node = parent->children[i];
+        }
+
+        int pos = rankInNode(node->keys, key);
+        std::memmove(node->keys + pos + 1, node->keys + pos, (node->count - pos) * sizeof(int));
+        node->keys[pos] = key;
+        node->count++;
+        total++;
+        return true;
+    }
+
+    bool searchNode(int key) const {
+        const BTreeNode* node = root;
+        while (node) {
+            int i = rankInNode(node->keys, key);
+            if (i < node->count && node->keys[i] == key) return true;
+            if (node->leaf) return false;
+            node = static_cast<const BTreeInternal*>(node)->children[i];
+        }
+        return false;
+    }
+
+    // Number of keys less than key
+    int order_of_key(int key) const {
+        int rank = 0;
+        const BTreeNode* node = root;
+        while (node) {
+            int i = rankInNode(node->keys, key);
+            rank += i;
+            if (node->leaf) break;
+            const BTreeInternal* internal = static_cast<const BTreeInternal*>(node);
+            for (int c = 0; c < i; c++) rank += internal->childSize[c];
+            if (i < node->count && node->keys[i] == key) {
+                rank += internal->childSize[i];
+                break;
+            }
+            node = internal->children[i];
+        }
+        return rank;
+    }
+
+    // Visit the keys in sorted order
+    template <typename F>
+    void forEach(F visit) const {
+        forEachAt(root, visit);
+    }
+
+    void inorder() const {
+        forEach([](int key) { std::cout << key << " "; });
+    }
+
+    int size() const { return total; }
+    int height() const { return levels; }  // Node levels, not key levels
+    size_t bytesReserved() const { return leaves.stats().bytesReserved + internals.stats().bytesReserved; }
+
+private:
+    BTreeNode* newLeaf() {
+        BTreeNode* node = leaves.create();
+        std::fill(node->keys, node->keys + SLOTS, INT_MAX);
+        node->count = 0;
+        node->leaf = true;
+        return node;
+    }
+
+    BTreeInternal* newInternal() {
+        BTreeInternal* node = internals.create();
+        std::fill(node->keys, node->keys + SLOTS, INT_MAX);
+        node->count = 0;
+        node->leaf = false;
+        return node;
+    }
+
+    // Split the full child i of parent around its median, which moves up into parent
+    void splitChild(BTreeInternal* parent, int i) {
+        const int half = MAX_KEYS / 2;
+        BTreeNode* left = parent->children[i];
+        BTreeNode* right = left->leaf ? newLeaf() : newInternal();
+
+        std::copy(left->keys + half + 1, left->keys + MAX_KEYS, right->keys);
+        right->count = MAX_KEYS - half - 1;
+        int median = left->keys[half];
+        std::fill(left->keys + half, left->keys + MAX_KEYS, INT_MAX);
+        left->count = half;
+
+        int leftSize = left->count, rightSize = right->count;
+        if (!left->leaf) {
+            BTreeInternal* from = static_cast<BTreeInternal*>(left);
+            BTreeInternal* to = static_cast<BTreeInternal*>(right);
+            for (int c = 0; c <= right->count; c++) {
+                to->children[c] = from->children[half + 1 + c];
+                to->childSize[c] = from->childSize[half + 1 + c];
+                rightSize += to->childSize[c];
+            }
+            for (int c = 0; c <= left->count; c++) leftSize += from->childSize[c];
+        }
+
+        for (int k = parent->count; k > i; k--) {
+            parent->keys[k] = parent->keys[k - 1];
+            parent->children[k + 1] = parent->children[k];
+            parent->childSize[k + 1] = parent->childSize[k];
+        }
+        parent->keys[i] = median;
+        parent->children[i + 1] = right;
+        parent->childSize[i] = leftSize;
+        parent->childSize[i + 1] = rightSize;
+        parent->count++;
+    }
+
+    template <typename F>
+    void forEachAt(const BTreeNode* node, F& visit) const {
+        if (!node) return;
+        const BTreeInternal* internal = node->leaf ? nullptr : static_cast<const BTreeInternal*>(node);
+        for (int i = 0; i < node->count; i++) {
+            if (internal) forEachAt(internal->children[i], visit);
+            visit(node->keys[i]);
+        }
+        if (internal) forEachAt(internal->children[node->count], visit);
+    }
+
+    BTreeNode* root;
+    int total;
+    int levels;
+    NodePool<BTreeNode> leaves;
+    NodePool<BTreeInternal> internals;
+};
+
+// Free-function forms matching the other trees' API
+inline void insert(BTree& tree, int key) { tree.insert(key); }
+inline bool searchNode(const BTree& tree, int key) { return tree.searchNode(key); }
+inline void inorder(const BTree& tree) { tree.inorder(); }
+inline int order_of_key(const BTree& tree, int key) { return tree.order_of_key(key); }
+
+}  // namespace btree
+
+#endif
@@ -0,0 +1,149 @@
+#ifndef COMPACT_AVL_TREE_H
+#define COMPACT_AVL_TREE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+// Compact AVL tree storage mode.
+// Nodes live in one contiguous array and refer to their children by 32-bit index,
+// with the height packed into a byte: 16 bytes per node instead of the 32 bytes of
+// AVLNode. Index 0 is a sentinel "null" node of height 0, so height lookups need
+// no null checks. Offers the same insert/searchNode/inorder operations as avl_tree.h.
+namespace avl {
+
+struct CompactAVLNode {
+    int data;
+    uint32_t left;
+    uint32_t right;
+    uint8_t height;
+};
+
+class CompactAVLTree {
+public:
+    static constexpr uint32_t NIL = 0;
+
+    CompactAVLTree() : nodes(1, CompactAVLNode{0, NIL, NIL, 0}), root(NIL) {}
+
+    // Reserve room for n keys up front to avoid regrowing the array
+    void reserve(size_t n) { nodes.reserve(n + 1); }
+
+    // Insert a key (duplicates are ignored, as in avl::insert)
+    void insert(int key) { root = insertAt(root, key); }
+
+    bool searchNode(int key) const {
+        uint32_t current = root;
+        while (current != NIL) {
+            const CompactAVLNode& node = nodes[current];
+            if (key == node.data) return true;
+            current = (key < node.data) ? node.left : node.right;
+        }
+        return false;
+    }
+
+    // Visit the keys in sorted order
+    template <typename F>
+    void forEach(F visit) const {
+        forEachAt(root, visit);
+    }
+
+    void inorder() const {
+        forEach([](int key) { std::cout << key << " "; });
+    }
+
+    size_t size() const { return nodes.size() - 1; }
+    int height() const { return nodes[root].height; }
+    size_t bytesReserved() const { return nodes.capacity() * sizeof(CompactAVLNode); }
+
+private:
+    int heightOf(uint32_t i) const { return nodes[i].height; }
+
+    void updateHeight(uint32_t i) {
+        nodes[i].height = (uint8_t)(1 + std::max(heightOf(nodes[i].left), heightOf(nodes[i].right)));
+    }
+
+    int balanceFactor(uint32_t i) const { return heightOf(nodes[i].left) - heightOf(nodes[i].right); }
+
+    uint32_t rightRotate(uint32_t y) {
+        uint32_t x = nodes[y].left;
+        nodes[y].left = nodes[x].right;
+        nodes[x].right = y;
+        updateHeight(y);
+        updateHeight(x);
+        return x;
+    }
+
+    uint32_t leftRotate(uint32_t x) {
+        uint32_t y = nodes[x].right;
+        nodes[x].right = nodes[y].left;
+        nodes[y].left = x;
+        updateHeight(x);
+        updateHeight(y);
+        return y;
+    }
+
+    // Same cases as avl::insert; children are re-read after recursing because
+    // appending a node may move the array
+    uint32_t insertAt(uint32_t node, int key) {
+        if (node == NIL) {
+            nodes.push_back(CompactAVLNode{key, NIL, NIL, 1});
+            return (uint32_t)(nodes.size() - 1);
+        }
+
+        if (key < nodes[node].data) {
+            uint32_t child = insertAt(nodes[node].left, key);
+            nodes[node].left = child;
+        } else if (key > nodes[node].data) {
+            uint32_t child = insertAt(nodes[node].right, key);
+            nodes[node].right = child;
+        } else {
+            return node;  // Duplicate keys not allowed
+        }
+
+        updateHeight(node);
+        int balance = balanceFactor(node);
+
+        // Left Left Case
+        if (balance > 1 && key < nodes[nodes[node].left].data)
+            return rightRotate(node);
+
+        // Right Right Case
+        if (balance < -1 && key > nodes[nodes[node].right].data)
+            return leftRotate(node);
+
+        // Left Right Case
+        if (balance > 1 && key > nodes[nodes[node].left].data) {
+            nodes[node].left = leftRotate(nodes[node].left);
+            return rightRotate(node);
+        }
+
+        // Right Left Case
+        if (balance < -1 && key < nodes[nodes[node].right].data) {
+            nodes[node].right = rightRotate(nodes[node].right);
+            return leftRotate(node);
+        }
+
+        return node;
+    }
+
+    template <typename F>
+    void forEachAt(uint32_t i, F& visit) const {
+        if (i == NIL) return;
+        forEachAt(nodes[i].left, visit);
+        visit(nodes[i].data);
+        forEachAt(nodes[i].right, visit);
+    }
+
+    std::vector<CompactAVLNode> nodes;
+    uint32_t root;
+};
+
+// Free-function forms matching the pointer-based AVL API
+inline void insert(CompactAVLTree& tree, int key) { tree.insert(key); }
+inline bool searchNode(const CompactAVLTree& tree, int key) { return tree.searchNode(key); }
+inline void inorder(const CompactAVLTree& tree) { tree.inorder(); }
+
+}  // namespace avl
+
+#endif
@@ -0,0 +1,224 @@
+#ifndef CONCURRENT_AVL_TREE_H
+#define CONCURRENT_AVL_TREE_H
+
+// Concurrent AVL tree for read-mostly workloads (RCU-style copy-on-write).
+// Published nodes are never modified. A writer (one at a time, under a mutex) copies
+// the path from the root to the insertion point, rebalances the copies and publishes
+// the new root with one atomic store, so lookups never take a lock and always see a
+// complete, balanced tree. Replaced nodes are retired and freed by epoch-based
+// reclamation once no reader that might still hold them is inside a lookup.
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "avl_tree.h"
+#include "node_pool.h"
+
+// Per-thread reader slots shared by all concurrent trees; a thread claims a slot the
+// first time it reads and gives it back when it exits
+class ReaderSlots {
+public:
+    static const unsigned MAX_THREADS = 256;
+
+    static unsigned self() {
+        thread_local Holder holder;
+        return holder.index;
+    }
+
+    static unsigned highWater() { return used().load(std::memory_order_seq_cst); }
+
+private:
+    struct Holder {
+        unsigned index;
+        Holder() : index(claim()) {}
+        ~Holder() { taken()[index].store(false, std::memory_order_release); }
+    };
+
+    static unsigned claim() {
+        for (unsigned i = 0; i < MAX_THREADS; i++) {
+            bool expected = false;
+            if (taken()[i].compare_exchange_strong(expected, true)) {
+                unsigned high = used().load();
+                while (high < i + 1 && !used().compare_exchange_weak(high, i + 1)) {
+                }
+                return i;
+            }
+        }
+        std::fprintf(stderr, "ReaderSlots: more than %u concurrent threads\n", MAX_THREADS);
+        std::abort();
+    }
+
+    static std::atomic<bool>* taken() {
+        static std::atomic<bool> slots[MAX_THREADS] = {};
+        return slots;
+    }
+
+    static std::atomic<unsigned>& used() {
+        static std::atomic<unsigned> count{0};
+        return count;
+    }
+};
+
+namespace avl {
+
+class ConcurrentAVLTree {
+public:
+    ConcurrentAVLTree() : root(nullptr) {
+        for (Epoch& e : readerEpochs) e.value.store(0, std::memory_order_relaxed);
+    }
+
+    ConcurrentAVLTree(const ConcurrentAVLTree&) = delete;
+    ConcurrentAVLTree& operator=(const ConcurrentAVLTree&) = delete;
+
+    // Lock-free lookup; safe from any number of threads
+    bool searchNode(int key) const {
+        ReadGuard guard(*this);
+        return avl::searchNode(root.load(std::memory_order_seq_cst), key);
+    }
+
+    // Insert a key (duplicates are ignored, as in avl::insert); writers serialize
+    void insert(int key) {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        AVLNode* current = root.load(std::memory_order_relaxed);
+        if (avl::searchNode(current, key)) return;
+
+        std::vector<AVLNode*> replaced;
+        AVLNode* updated = insertCopy(current, key, replaced);
+        root.store(updated, std::memory_order_seq_cst);
+        retire(replaced);
+    }
+
+    // Number of keys (reads the root's cached size)
+    int size() const {
+        ReadGuard guard(*this);
+        return getSize(root.load(std::memory_order_seq_cst));
+    }
+
+    int height() const {
+        ReadGuard guard(*this);
+        return getHeight(root.load(std::memory_order_seq_cst));
+    }
+
+    // Visit the keys in order, all from the version published when the walk began.
+    // Lock-free like searchNode; visit must not call back into this tree.
+    template <typename F>
+    void forEach(F visit) const {
+        ReadGuard guard(*this);
+        core::forEachInorder(root.load(std::memory_order_seq_cst), [&](AVLNode* node) { visit(node->data); });
+    }
+
+    // Nodes retired but not yet reclaimed
+    size_t pendingReclaim() const {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        size_t pending = 0;
+        for (const Retired& batch : limbo) pending += batch.nodes.size();
+        return pending;
+    }
+
+private:
+    struct alignas(64) Epoch {
+        std::atomic<uint64_t> value;  // 0 = not reading, otherwise the epoch the read began in
+    };
+
+    struct Retired {
+        uint64_t epoch;
+        std::vector<AVLNode*> nodes;
+    };
+
+    // Announces the current epoch for the duration of a lookup
+    struct ReadGuard {
+        std::atomic<uint64_t>& slot;
+        explicit ReadGuard(const ConcurrentAVLTree& tree) : slot(tree.readerEpochs[ReaderSlots::self()].value) {
+            slot.store(tree.globalEpoch.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+        }
+        ~ReadGuard() { slot.store(0, std::memory_order_release); }
+    };
+
+    AVLNode* copyOf(AVLNode* node) {
+        AVLNode* copy = pool.create(node->data);
+        copy->left = node->left;
+        copy->right = node->right;
+        copy->height = node->height;
+        copy->size = node->size;
+        return copy;
+    }
+
+    // avl::insert on fresh copies of the search path; every node a rotation touches
+    // lies on that path, so published nodes are never written
+    AVLNode* insertCopy(AVLNode* node, int key, std::vector<AVLNode*>& replaced) {
+        if (node == nullptr) return pool.create(key);
+
+        replaced.push_back(node);
+        node = copyOf(node);
+        if (key < node->data)
+            node->left = insertCopy(node->left, key, replaced);
+        else
+            node->right = insertCopy(node->right, key, replaced);
+
+        updateHeightAndSize(node);
+        int balance = getBalanceFactor(node);
+
+        // Left Left Case
+        if (balance > 1 && key < node->left->data)
+            return rightRotate(node);
+
+        // Right Right Case
+        if (balance < -1 && key > node->right->data)
+            return leftRotate(node);
+
+        // Left Right Case
+        if (balance > 1 && key > node->left->data) {
+            node->left = leftRotate(node->left);
+            return rightRotate(node);
+        }
+
+        // Right Left Case
+        if (balance < -1 && key < node->right->data) {
+            node->right = rightRotate(node->right);
+            return leftRotate(node);
+        }
+
+        return node;
+    }
+
+    // Tag the replaced nodes with the current epoch, advance it and free every batch
+    // older than the oldest active reader. Called with writeMutex held.
+    void retire(std::vector<AVLNode*>& nodes) {
+        uint64_t epoch = globalEpoch.fetch_add(1, std::memory_order_seq_cst);
+        limbo.push_back(Retired{epoch, std::move(nodes)});
+
+        uint64_t oldest = UINT64_MAX;
+        unsigned slots = ReaderSlots::highWater();
+        for (unsigned i = 0; i < slots; i++) {
+            uint64_t e = readerEpochs[i].value.load(std::memory_order_seq_cst);
+            if (e != 0 && e < oldest) oldest = e;
+        }
+
+        size_t kept = 0;
+        for (size_t i = 0; i < limbo.size(); i++) {
+            if (limbo[i].epoch < oldest) {
+                for (AVLNode* node : limbo[i].nodes) pool.destroy(node);
+            } else {
+                if (kept != i) limbo[kept] = std::move(limbo[i]);
+                kept++;
+            }
+        }
+        limbo.resize(kept);
+    }
+
+    std::atomic<AVLNode*> root;
+    std::atomic<uint64_t> globalEpoch{1};
+    mutable Epoch readerEpochs[ReaderSlots::MAX_THREADS];
+    mutable std::mutex writeMutex;
+    NodePool<AVLNode> pool;  // Only touched by the writer
+    std::vector<Retired> limbo;
+};
+
+}  // namespace avl
+
+#endif
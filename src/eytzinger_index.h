@@ -0,0 +1,138 @@
+#ifndef EYTZINGER_INDEX_H
+#define EYTZINGER_INDEX_H
+
+// Static search index in Eytzinger (BFS) order, frozen from an AVL tree.
+// The sorted keys are laid out as an implicit complete tree: the children of slot k
+// are 2k and 2k+1, so the first levels of every search share a few cache lines and
+// the descent needs no pointers. The search is branchless (the comparison result is
+// added to the index) and prefetches the cache line holding the node's 16
+// great-great-grandchildren, four levels ahead. searchBatch interleaves a group of
+// queries level by level so their cache misses overlap. Read-only: rebuild it with
+// avl::freeze after the tree changes.
+
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "avl_tree.h"
+
+namespace avl {
+
+class EytzingerIndex {
+public:
+    EytzingerIndex() : n(0), levels(0), slots(nullptr) {}
+
+    // Build from strictly increasing keys
+    explicit EytzingerIndex(const std::vector<int>& sorted) {
+        n = sorted.size();
+        levels = 0;
+        while (((size_t)1 << levels) <= n) levels++;
+
+        // Slot 1 must start a 64-byte line so each 16-slot group k*16..k*16+15 fills one line
+        storage.assign(n + 1 + 16, INT_MAX);
+        uintptr_t address = reinterpret_cast<uintptr_t>(storage.data() + 1);
+        size_t shift = ((64 - address % 64) % 64) / sizeof(int);
+        slots = storage.data() + shift;
+
+        size_t next = 0;
+        fill(sorted, next, 1);
+    }
+
+    EytzingerIndex(const EytzingerIndex&) = delete;
+    EytzingerIndex& operator=(const EytzingerIndex&) = delete;
+    EytzingerIndex(EytzingerIndex&&) = default;
+    EytzingerIndex& operator=(EytzingerIndex&&) = default;
+
+    size_t size() const { return n; }
+    size_t bytes() const { return storage.capacity() * sizeof(int); }
+
+    bool searchNode(int key) const {
+        size_t k = lowerBoundSlot(key);
+        return k != 0 && slots[k] == key;
+    }
+
+    // Smallest key >= key; returns false when every key is smaller
+    bool lowerBound(int key, int& result) const {
+        size_t k = lowerBoundSlot(key);
+        if (k == 0) return false;
+        result = slots[k];
+        return true;
+    }
+
+    // found[i] = searchNode(keys[i]), answered GROUP queries at a time
+    void searchBatch(const int* keys, size_t count, bool* found) const {
+        const size_t GROUP = 16;
+        size_t k[GROUP];
+        for (size_t base = 0; base < count; base += GROUP) {
+            size_t m = (count - base < GROUP) ? count - base : GROUP;
+            for (size_t j = 0; j < m; j++) k[j] = 1;
+            // Every level but the last is full, so these reads stay in bounds
+            for (int level = 1; level < levels; level++) {
+                for (size_t j = 0; j < m; j++) {
+                    __builtin_prefetch(slots + k[j] * 16);
+                    k[j] = 2 * k[j] + (slots[k[j]] < keys[base + j]);
+                }
+            }
+            for (size_t j = 0; j < m; j++) {
+                size_t slot = finish(k[j], keys[base + j]);
+                found[base + j] = slot != 0 && slots[slot] == keys[base + j];
+            }
+        }
+    }
+
+private:
+    // In-order walk of the implicit tree hands out the sorted keys
+    void fill(const std::vector<int>& sorted, size_t& next, size_t k) {
+        if (k > n) return;
+        fill(sorted, next, 2 * k);
+        slots[k] = sorted[next++];
+        fill(sorted, next, 2 * k + 1);
+    }
+
+    // Slot of the smallest key >= key, or 0 if none
+    size_t lowerBoundSlot(int key) const {
+        size_t k = 1;
+        for (int level = 1; level < levels; level++) {
+            __builtin_prefetch(slots + k * 16);
+            k = 2 * k + (slots[k] < key);
+        }
+        return finish(k, key);
+    }
+
+    // Take the last, possibly partial, level, then undo the trailing right turns
+    // (the 1 bits) and the final left turn: what remains is the last node where
+    // the search went left, i.e. the lower bound
+    size_t finish(size_t k, int key) const {
+        if (k <= n) k = 2 * k + (slots[k] < key);
+        return k >> __builtin_ffsll((long long)~k);
+    }
+
+    size_t n;
+    int levels;  // Levels of the implicit tree: floor(log2 n) + 1
+    std::vector<int> storage;
+    int* slots;  // 1-based view into storage, 64-byte aligned at slots + 1
+};
+
+// Export the keys of an AVL tree into a static Eytzinger index
+inline EytzingerIndex freeze(AVLNode* root) {
+    std::vector<int> sorted;
+    sorted.reserve(getSize(root));
+    std::vector<AVLNode*> stack;
+    AVLNode* current = root;
+    while (current || !stack.empty()) {
+        while (current) {
+            stack.push_back(current);
+            current = current->left;
+        }
+        current = stack.back();
+        stack.pop_back();
+        sorted.push_back(current->data);
+        current = current->right;
+    }
+    return EytzingerIndex(sorted);
+}
+
+}  // namespace avl
+
+#endif
@@ -0,0 +1,46 @@
+#ifndef GRAPHICS_STUB_H
+#define GRAPHICS_STUB_H
+
+// No-op stand-in for the BGI graphics.h API.
+// Lets the visualizers build and run on machines without WinBGIm or a display
+// (compile with -DHEADLESS); every drawing call simply does nothing.
+
+#include <cstdio>
+
+enum { DETECT = 0 };
+enum { SOLID_FILL = 1 };
+enum { DEFAULT_FONT = 0, SANS_SERIF_FONT = 3 };
+enum { HORIZ_DIR = 0 };
+
+enum {
+    BLACK, BLUE, GREEN, CYAN, RED, MAGENTA, BROWN, LIGHTGRAY,
+    DARKGRAY, LIGHTBLUE, LIGHTGREEN, LIGHTCYAN, LIGHTRED, LIGHTMAGENTA, YELLOW, WHITE
+};
+
+inline int COLOR(int r, int g, int b) { return (r << 16) | (g << 8) | b; }
+
+inline void initgraph(int*, int*, const char*) {}
+inline int initwindow(int, int, const char* = "") { return 0; }
+inline void closegraph() {}
+inline void cleardevice() {}
+inline void setbkcolor(int) {}
+inline void setcolor(int) {}
+inline void setfillstyle(int, int) {}
+inline void settextstyle(int, int, int) {}
+inline void circle(int, int, int) {}
+inline void fillellipse(int, int, int, int) {}
+inline void floodfill(int, int, int) {}
+inline void line(int, int, int, int) {}
+inline void bar(int, int, int, int) {}
+inline void setviewport(int, int, int, int, int) {}
+inline void outtextxy(int, int, const char*) {}
+inline void delay(int) {}
+inline int getch() { return 0; }
+
+// itoa is a MinGW extension; provide it for the base-10 use in the visualizers
+inline char* itoa(int value, char* str, int) {
+    std::sprintf(str, "%d", value);
+    return str;
+}
+
+#endif
@@ -0,0 +1,136 @@
+#ifndef IMPLICIT_TREE_H
+#define IMPLICIT_TREE_H
+
+#include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <iostream>
+#include <vector>
+
+#include "binary_tree.h"
+#include "node_pool.h"
+
+// Array-backed storage mode for the plain binary tree.
+// The node in slot i has its children in slots 2i+1 and 2i+2; absent nodes hold the
+// sentinel INT_MIN (so INT_MIN itself cannot be stored). A tree built from a level-
+// order stream (the order the visualizer prompts for nodes, -1 for "no child") is
+// laid out in one pass with no pointers, no queue and no per-node allocation:
+// the next parent is simply the next occupied slot. Level order is then a plain scan
+// of the array, the height follows from the last occupied slot, and leaves are found
+// by looking at each slot's two child slots.
+//
+// The layout suits complete and nearly complete trees. Holes cost slots (a missing
+// child at depth d leaves a whole missing subtree), so the build gives up once the
+// array would grow past maxSlotsPerNode slots per stored node (with a floor of
+// minSlotLimit); toPointerTree() turns what has been built into the usual t_node tree.
+
+namespace bt {
+
+class ImplicitTree {
+public:
+    static constexpr int absent = INT_MIN;
+    static constexpr size_t maxSlotsPerNode = 8;
+    static constexpr size_t minSlotLimit = 1 << 20;
+
+    // Add the next key of a level-order stream; -1 leaves the slot empty. Returns false
+    // once the key cannot be stored: the stream has no open slot left (every remaining
+    // child was -1), the key is the sentinel, or the array would get too sparse.
+    bool push(int key) {
+        if (failed) return false;
+        if (slots.empty()) return store(0, key);  // The first key is the root, as in the pointer loader
+        if (leftNext) {
+            // The next parent is the next occupied slot after the current one
+            size_t next = started ? parent + 1 : 0;
+            while (next < slots.size() && slots[next] == absent) next++;
+            if (next >= slots.size()) return false;  // No open slots left
+            parent = next;
+            started = true;
+        }
+        size_t slot = 2 * parent + (leftNext ? 1 : 2);
+        leftNext = !leftNext;
+        if (key == -1) return true;
+        return store(slot, key);
+    }
+
+    // True if the build gave up (sentinel key or too sparse); the tree holds the keys before that
+    bool gaveUp() const { return failed; }
+
+    int countNodes() const { return count; }
+    size_t slotCount() const { return slots.size(); }
+    bool present(size_t i) const { return i < slots.size() && slots[i] != absent; }
+    int key(size_t i) const { return slots[i]; }
+
+    // Visit the keys in level order: one scan of the array
+    template <typename F>
+    void forEachLevelOrder(F visit) const {
+        for (int key : slots)
+            if (key != absent) visit(key);
+    }
+
+    // Function to find the height of the tree: the depth of the last occupied slot
+    // (the array never ends in an empty slot), so O(1)
+    int findHeight() const {
+        int height = 0;
+        for (size_t last = slots.size(); last > 0; last >>= 1) height++;  // floor(log2(size)) + 1
+        return height;
+    }
+
+    // Function to count leaf nodes: occupied slots whose two child slots are empty
+    int countLeafNodes() const {
+        int leaves = 0;
+        for (size_t i = 0; i < slots.size(); i++)
+            if (slots[i] != absent && !present(2 * i + 1) && !present(2 * i + 2)) leaves++;
+        return leaves;
+    }
+
+    // Function to search a key: a linear scan, but over contiguous memory
+    bool searchNode(int key) const {
+        if (key == absent) return false;
+        return std::find(slots.begin(), slots.end(), key) != slots.end();
+    }
+
+    // The same tree as linked nodes with their sizes set, for the operations that
+    // need pointers (traversals other than level order, drawing, statistics). O(slots).
+    t_node* toPointerTree(NodePool<t_node>* pool) const {
+        std::vector<t_node*> nodes(slots.size(), nullptr);
+        for (size_t i = 0; i < slots.size(); i++)
+            if (slots[i] != absent) nodes[i] = newNode(pool, slots[i]);
+        // Children come after their parent, so a backwards pass sees them finished
+        for (size_t i = slots.size(); i-- > 0;) {
+            t_node* node = nodes[i];
+            if (!node) continue;
+            if (2 * i + 1 < nodes.size()) node->left = nodes[2 * i + 1];
+            if (2 * i + 2 < nodes.size()) node->right = nodes[2 * i + 2];
+            node->size = 1 + core::getSize(node->left) + core::getSize(node->right);
+        }
+        return nodes.empty() ? nullptr : nodes[0];
+    }
+
+private:
+    bool store(size_t slot, int key) {
+        if (key == absent || slot >= std::max(minSlotLimit, maxSlotsPerNode * (count + 1))) {
+            failed = true;
+            return false;
+        }
+        if (slot >= slots.size()) slots.resize(slot + 1, absent);
+        slots[slot] = key;
+        count++;
+        return true;
+    }
+
+    std::vector<int> slots;
+    int count = 0;
+    size_t parent = 0;
+    bool started = false;  // parent is meaningful once the first child slot was handed out
+    bool leftNext = true;
+    bool failed = false;
+};
+
+// Print the keys in level order, as LevelOrder does for the pointer tree
+inline void LevelOrder(const ImplicitTree& tree) {
+    tree.forEachLevelOrder([](int key) { std::cout << key << " "; });
+}
+
+}  // namespace bt
+
+#endif
@@ -0,0 +1,173 @@
+#ifndef KEY_INDEX_H
+#define KEY_INDEX_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "binary_tree.h"
+
+// Hash side-index for the plain binary tree.
+// The tree has no key order, so searchNode may visit every node. KeyIndex maps each
+// key to the first node added with it and to how many nodes hold it, in an open-
+// addressing table (linear probing, at most half full, Fibonacci hashing), so a
+// lookup is one or two cache lines whatever the tree's size. Nodes are never removed
+// from the plain tree, so the table needs no tombstones; call add() for every node
+// linked in to keep it consistent.
+//
+// With the Bloom pre-check on, a blocked Bloom filter (three bits in one 64-bit word,
+// about 16 bits per key) is tested first; it is 1/16 the size of the table, so most
+// misses are answered from a structure that stays in cache.
+//
+// order_of_key counts the keys (with duplicates) less than a key. It is answered by
+// binary search over the distinct keys in order with their running counts, sorted
+// again on the first query after keys were added.
+
+namespace bt {
+
+class KeyIndex {
+public:
+    explicit KeyIndex(bool bloom = false) : useBloom(bloom) { resize(16); }
+
+    // Record one node (its key must not change afterwards)
+    void add(t_node* node) {
+        if (2 * (size_t)(distinct + 1) > table.size()) resize(2 * table.size());
+        Slot& slot = table[probe(node->data)];
+        if (slot.count == 0) {
+            slot.key = node->data;
+            slot.node = node;
+            distinct++;
+            if (useBloom) bloomAdd(node->data);
+        }
+        slot.count++;
+        total++;
+        ranksStale = true;
+    }
+
+    // Record every node of the tree
+    void build(t_node* root) {
+        core::forEachLevelOrder(root, [&](t_node* node) { add(node); });
+    }
+
+    // False when the Bloom filter rules key out (always true without the filter)
+    bool mayContain(int key) const { return !useBloom || bloomMayContain(key); }
+
+    // Function to find the first node added with key; nullptr if none
+    t_node* find(int key) const {
+        if (!mayContain(key)) return nullptr;
+        const Slot& slot = table[probe(key)];
+        return slot.count ? slot.node : nullptr;
+    }
+
+    bool contains(int key) const { return find(key) != nullptr; }
+
+    // Function to count the nodes holding key
+    int count(int key) const {
+        if (!mayContain(key)) return 0;
+        return table[probe(key)].count;
+    }
+
+    // Function to find the number of elements less than the given key
+    int order_of_key(int key) {
+        if (ranksStale) sortKeys();
+        size_t i = std::lower_bound(sortedKeys.begin(), sortedKeys.end(), key) - sortedKeys.begin();
+        return i < sortedKeys.size() ? below[i] : total;
+    }
+
+    int size() const { return total; }
+    int distinctKeys() const { return distinct; }
+    bool bloomEnabled() const { return useBloom; }
+
+    // Memory of the table and the filter (not the sorted copy), in bytes
+    size_t bytes() const { return table.size() * sizeof(Slot) + bloom.size() * sizeof(uint64_t); }
+
+private:
+    struct Slot {
+        int key = 0;
+        int count = 0;  // 0: empty
+        t_node* node = nullptr;
+    };
+
+    static uint64_t mix(int key) { return (uint64_t)(uint32_t)key * 0x9E3779B97F4A7C15ull; }
+
+    // Slot holding key, or the empty slot where it would go
+    size_t probe(int key) const {
+        size_t mask = table.size() - 1;
+        size_t i = (size_t)(mix(key) >> shift);
+        while (table[i].count && table[i].key != key) i = (i + 1) & mask;
+        return i;
+    }
+
+    void resize(size_t capacity) {
+        std::vector<Slot> old;
+        old.swap(table);
+        table.assign(capacity, Slot());
+        shift = 64;
+        for (size_t c = capacity; c > 1; c >>= 1) shift--;
+        // One filter word per 8 slots: at most half full, so 16 bits per key or more
+        if (useBloom) bloom.assign(std::max<size_t>(1, capacity / 8), 0);
+        for (const Slot& s : old) {
+            if (!s.count) continue;
+            table[probe(s.key)] = s;
+            if (useBloom) bloomAdd(s.key);
+        }
+    }
+
+    // The filter hash is the splitmix64 finalizer, so every output bit depends on every
+    // key bit (a bare multiplicative hash leaves its low bits poorly mixed, and nearby
+    // keys then share words). The word comes from the high 32 bits, the three bit
+    // positions from the low 18.
+    static uint64_t bloomHash(int key) {
+        uint64_t h = (uint64_t)(uint32_t)key + 0x9E3779B97F4A7C15ull;
+        h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ull;
+        h = (h ^ (h >> 27)) * 0x94D049BB133111EBull;
+        return h ^ (h >> 31);
+    }
+
+    size_t bloomWord(uint64_t h) const { return (size_t)(((h >> 32) * bloom.size()) >> 32); }
+
+    static uint64_t bloomBits(uint64_t h) {
+        return (1ull << (h & 63)) | (1ull << ((h >> 6) & 63)) | (1ull << ((h >> 12) & 63));
+    }
+
+    void bloomAdd(int key) {
+        uint64_t h = bloomHash(key);
+        bloom[bloomWord(h)] |= bloomBits(h);
+    }
+
+    bool bloomMayContain(int key) const {
+        uint64_t h = bloomHash(key), bits = bloomBits(h);
+        return (bloom[bloomWord(h)] & bits) == bits;
+    }
+
+    void sortKeys() {
+        std::vector<std::pair<int, int>> keys;
+        keys.reserve(distinct);
+        for (const Slot& s : table)
+            if (s.count) keys.push_back({s.key, s.count});
+        std::sort(keys.begin(), keys.end());
+        sortedKeys.resize(keys.size());
+        below.resize(keys.size());
+        int less = 0;
+        for (size_t i = 0; i < keys.size(); i++) {
+            sortedKeys[i] = keys[i].first;
+            below[i] = less;
+            less += keys[i].second;
+        }
+        ranksStale = false;
+    }
+
+    bool useBloom;
+    std::vector<Slot> table;
+    int shift = 64;
+    int distinct = 0, total = 0;
+    std::vector<uint64_t> bloom;
+    std::vector<int> sortedKeys, below;  // Distinct keys in order, and how many keys are less than each
+    bool ranksStale = true;
+};
+
+}  // namespace bt
+
+#endif
@@ -0,0 +1,231 @@
+#ifndef KEY_READER_H
+#define KEY_READER_H
+
+// Batch key input for the tree programs.
+// Reads keys from a file or stdin without building a std::string per token:
+//   text   signed decimal integers separated by any non-digit characters
+//   bin32  raw native-endian int32 values
+//   bin64  raw native-endian int64 values (values outside int range are rejected)
+// Regular files are mapped with mmap where available and parsed in place; stdin
+// and other streams are read in 1 MiB chunks.
+
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+enum KeyFormat { KEYS_TEXT, KEYS_BIN32, KEYS_BIN64 };
+
+struct KeyReadStats {
+    size_t bytes = 0;
+    size_t keys = 0;
+    size_t rejected = 0;  // Out of int range
+};
+
+// Incremental decimal parser; keeps its state between chunks so a number may
+// straddle a chunk boundary
+struct TextKeyParser {
+    long long value = 0;
+    bool negative = false;
+    bool inNumber = false;
+
+    template <typename F>
+    void feed(const char* p, const char* end, F& onKey, KeyReadStats& stats) {
+        while (p < end) {
+            unsigned digit = (unsigned char)*p - '0';
+            if (digit < 10) {
+                // Saturate instead of overflowing; anything this large is rejected anyway
+                if (value < (long long)1 << 40) value = value * 10 + digit;
+                inNumber = true;
+            } else {
+                if (inNumber) emit(onKey, stats);
+                negative = (*p == '-');
+            }
+            p++;
+        }
+    }
+
+    template <typename F>
+    void finish(F& onKey, KeyReadStats& stats) {
+        if (inNumber) emit(onKey, stats);
+    }
+
+private:
+    template <typename F>
+    void emit(F& onKey, KeyReadStats& stats) {
+        long long key = negative ? -value : value;
+        if (key < INT_MIN || key > INT_MAX) {
+            stats.rejected++;
+        } else {
+            onKey((int)key);
+            stats.keys++;
+        }
+        value = 0;
+        inNumber = false;
+    }
+};
+
+// Decode whole binary records from [p, end); returns the number of bytes consumed
+template <typename F>
+inline size_t decodeBinaryKeys(const char* p, const char* end, KeyFormat format, F& onKey, KeyReadStats& stats) {
+    size_t width = (format == KEYS_BIN32) ? 4 : 8;
+    size_t records = (size_t)(end - p) / width;
+    for (size_t i = 0; i < records; i++, p += width) {
+        if (format == KEYS_BIN32) {
+            int32_t key;
+            std::memcpy(&key, p, 4);
+            onKey((int)key);
+            stats.keys++;
+        } else {
+            int64_t key;
+            std::memcpy(&key, p, 8);
+            if (key < INT_MIN || key > INT_MAX) {
+                stats.rejected++;
+                continue;
+            }
+            onKey((int)key);
+            stats.keys++;
+        }
+    }
+    return records * width;
+}
+
+// Parse keys from a buffer already in memory
+template <typename F>
+inline void forEachKeyInMemory(const char* data, size_t size, KeyFormat format, F onKey, KeyReadStats* stats = nullptr) {
+    KeyReadStats local;
+    KeyReadStats& s = stats ? *stats : local;
+    s.bytes += size;
+    if (format == KEYS_TEXT) {
+        TextKeyParser parser;
+        parser.feed(data, data + size, onKey, s);
+        parser.finish(onKey, s);
+    } else {
+        decodeBinaryKeys(data, data + size, format, onKey, s);
+    }
+}
+
+// Parse keys from a stream in 1 MiB chunks
+template <typename F>
+inline void forEachKeyInStream(FILE* file, KeyFormat format, F onKey, KeyReadStats* stats = nullptr) {
+    KeyReadStats local;
+    KeyReadStats& s = stats ? *stats : local;
+    std::vector<char> buffer(1 << 20);
+    TextKeyParser parser;
+    size_t carried = 0;  // Partial binary record left over from the previous chunk
+    size_t got;
+    while ((got = std::fread(buffer.data() + carried, 1, buffer.size() - carried, file)) > 0) {
+        s.bytes += got;
+        if (format == KEYS_TEXT) {
+            parser.feed(buffer.data(), buffer.data() + got, onKey, s);
+            continue;
+        }
+        size_t available = carried + got;
+        size_t used = decodeBinaryKeys(buffer.data(), buffer.data() + available, format, onKey, s);
+        carried = available - used;
+        std::memmove(buffer.data(), buffer.data() + used, carried);
+    }
+    if (format == KEYS_TEXT) parser.finish(onKey, s);
+}
+
+// Parse keys from a file ("-" for stdin). Returns false if the file cannot be opened.
+template <typename F>
+inline bool forEachKey(const std::string& path, KeyFormat format, F onKey, KeyReadStats* stats = nullptr, bool useMmap = true) {
+    if (path == "-") {
+        forEachKeyInStream(stdin, format, onKey, stats);
+        return true;
+    }
+
+#if defined(__unix__) || defined(__APPLE__)
+    if (useMmap) {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+            void* mapped = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped != MAP_FAILED) {
+                madvise(mapped, (size_t)st.st_size, MADV_SEQUENTIAL);
+                forEachKeyInMemory(static_cast<const char*>(mapped), (size_t)st.st_size, format, onKey, stats);
+                munmap(mapped, (size_t)st.st_size);
+                close(fd);
+                return true;
+            }
+        }
+        close(fd);  // Empty or unmappable (e.g. a named pipe): fall back to reading
+    }
+#endif
+
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) return false;
+    forEachKeyInStream(file, format, onKey, stats);
+    std::fclose(file);
+    return true;
+}
+
+// Command-line options for batch mode:
+//   --batch <file|->  --format text|bin32|bin64  --bulk (BST/AVL: build balanced)
+//   --stats (print the tree statistics as JSON and exit instead of opening the menu)
+//   --load <snapshot> / --save <snapshot> (BST/AVL: start from / write a binary snapshot)
+//   --render <file.svg|file.ppm> (draw the loaded tree offscreen into an image file)
+//   --implicit (binary tree: keep the level-order batch in an implicit array, see implicit_tree.h)
+//   --index (binary tree: answer search and order of key from a hash index, see key_index.h)
+//   --bloom (as --index, with a Bloom filter in front of the index for misses)
+struct BatchOptions {
+    std::string path;
+    std::string loadPath;
+    std::string savePath;
+    std::string renderPath;
+    KeyFormat format = KEYS_TEXT;
+    bool bulk = false;
+    bool implicit = false;
+    bool index = false;
+    bool bloom = false;
+    bool statsOnly = false;
+    bool badFormat = false;
+
+    bool enabled() const { return !path.empty(); }
+};
+
+inline BatchOptions parseBatchOptions(int argc, char** argv) {
+    BatchOptions options;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--batch" && i + 1 < argc) {
+            options.path = argv[++i];
+        } else if (arg == "--format" && i + 1 < argc) {
+            std::string format = argv[++i];
+            if (format == "text") options.format = KEYS_TEXT;
+            else if (format == "bin32") options.format = KEYS_BIN32;
+            else if (format == "bin64") options.format = KEYS_BIN64;
+            else options.badFormat = true;
+        } else if (arg == "--bulk") {
+            options.bulk = true;
+        } else if (arg == "--implicit") {
+            options.implicit = true;
+        } else if (arg == "--index") {
+            options.index = true;
+        } else if (arg == "--bloom") {
+            options.index = options.bloom = true;
+        } else if (arg == "--load" && i + 1 < argc) {
+            options.loadPath = argv[++i];
+        } else if (arg == "--save" && i + 1 < argc) {
+            options.savePath = argv[++i];
+        } else if (arg == "--render" && i + 1 < argc) {
+            options.renderPath = argv[++i];
+        } else if (arg == "--stats") {
+            options.statsOnly = true;
+        }
+    }
+    return options;
+}
+
+#endif
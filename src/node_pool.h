@@ -0,0 +1,121 @@
+#ifndef NODE_POOL_H
+#define NODE_POOL_H
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Allocator statistics reported by NodePool::stats()
+struct PoolStats {
+    size_t bytesReserved;  // Memory held in slabs
+    size_t liveNodes;      // Nodes handed out and not yet destroyed
+    size_t freeNodes;      // Destroyed nodes waiting on the free list for reuse
+    double fragmentation;  // freeNodes / (liveNodes + freeNodes)
+};
+
+// Slab allocator for tree nodes.
+// Nodes are carved out of large slabs (doubling up to 1M nodes per slab), destroyed
+// nodes go on an intrusive free list for reuse, and release() drops the whole tree
+// by freeing the slabs, without walking it. Nodes must be trivially destructible.
+template <typename Node>
+class NodePool {
+    static_assert(std::is_trivially_destructible<Node>::value, "pool nodes are released without running destructors");
+
+    union Slot {
+        Slot* next;
+        alignas(Node) unsigned char storage[sizeof(Node)];
+    };
+
+public:
+    NodePool() {}
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+    ~NodePool() { release(); }
+
+    // Construct a node in the pool
+    template <typename... Args>
+    Node* create(Args&&... args) {
+        Slot* slot = freeList;
+        if (slot) {
+            freeList = slot->next;
+            freeCount--;
+        } else {
+            if (used == capacity) grow();
+            slot = &slabs.back().first[used++];
+        }
+        live++;
+        return new (slot->storage) Node(std::forward<Args>(args)...);
+    }
+
+    // Return a single node to the free list
+    void destroy(Node* node) {
+        Slot* slot = reinterpret_cast<Slot*>(node);
+        slot->next = freeList;
+        freeList = slot;
+        freeCount++;
+        live--;
+    }
+
+    // Free every node at once; pointers into the pool become invalid
+    void release() {
+        for (auto& slab : slabs) deallocate(slab.first);
+        slabs.clear();
+        freeList = nullptr;
+        used = capacity = 0;
+        live = freeCount = reserved = 0;
+    }
+
+    PoolStats stats() const {
+        size_t handedOut = live + freeCount;
+        return {reserved, live, freeCount, handedOut ? (double)freeCount / handedOut : 0.0};
+    }
+
+private:
+    // Over-aligned nodes (e.g. alignas(64) B-tree nodes) need the aligned operator new
+    static void* allocate(size_t bytes) {
+        if constexpr (alignof(Slot) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+            return ::operator new(bytes, std::align_val_t(alignof(Slot)));
+        else
+            return ::operator new(bytes);
+    }
+
+    static void deallocate(void* slab) {
+        if constexpr (alignof(Slot) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+            ::operator delete(slab, std::align_val_t(alignof(Slot)));
+        else
+            ::operator delete(slab);
+    }
+
+    void grow() {
+        size_t nodes = slabs.empty() ? 256 : std::min<size_t>(slabs.back().second * 2, 1 << 20);
+        Slot* slab = static_cast<Slot*>(allocate(nodes * sizeof(Slot)));
+        slabs.push_back({slab, nodes});
+        reserved += nodes * sizeof(Slot);
+        used = 0;
+        capacity = nodes;
+    }
+
+    std::vector<std::pair<Slot*, size_t>> slabs;
+    Slot* freeList = nullptr;
+    size_t used = 0, capacity = 0;
+    size_t live = 0, freeCount = 0, reserved = 0;
+};
+
+// Allocate from the pool when one is given, otherwise fall back to plain new
+template <typename Node, typename... Args>
+inline Node* newNode(NodePool<Node>* pool, Args&&... args) {
+    if (pool) return pool->create(std::forward<Args>(args)...);
+    return new Node(std::forward<Args>(args)...);
+}
+
+// Counterpart of newNode
+template <typename Node>
+inline void deleteNode(NodePool<Node>* pool, Node* node) {
+    if (pool) pool->destroy(node);
+    else delete node;
+}
+
+#endif
@@ -0,0 +1,214 @@
+#ifndef PARALLEL_TREE_H
+#define PARALLEL_TREE_H
+
+// Fork-join analytics over large trees.
+// TaskPool is a small work-stealing executor: every worker owns a deque, pushes and
+// pops its own tasks at the back and steals from the front of the others' deques.
+// A thread waiting on a TaskGroup runs queued tasks instead of blocking, so nested
+// fork-join cannot deadlock. The tree walks fork a task per subtree and use the
+// serial walks (computeStats, an explicit-stack search) below it, so the results are
+// identical to the serial functions.
+//
+// Where to stop forking: nodes that cache their subtree size (SizeAugment) are split
+// while the subtree holds at least parallelGrain nodes, so a lopsided tree is cut
+// where the work is rather than at a fixed level. spawnDepth caps the forking depth
+// in every case, and is the only cutoff for nodes without sizes. A fixed depth suits
+// full trees only: on a skewed tree most of the 2^depth tasks are empty or tiny and
+// one of them holds nearly all nodes. Sizes are only a hint, so stale ones (the plain
+// binary tree updates them on demand) cost speed, never correctness.
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "tree_stats.h"
+
+struct TaskGroup {
+    std::atomic<int> pending{0};
+};
+
+class TaskPool {
+public:
+    // threads counts the calling thread, which works while it waits
+    explicit TaskPool(unsigned threads) {
+        threads = std::max(1u, threads);
+        for (unsigned i = 0; i < threads; i++) queues.emplace_back(new Queue);
+        for (unsigned i = 1; i < threads; i++) workers.emplace_back([this, i] { workerLoop(i); });
+    }
+
+    TaskPool(const TaskPool&) = delete;
+    TaskPool& operator=(const TaskPool&) = delete;
+
+    ~TaskPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (std::thread& worker : workers) worker.join();
+    }
+
+    unsigned size() const { return (unsigned)queues.size(); }
+
+    // Queue f as part of group
+    void spawn(TaskGroup& group, std::function<void()> f) {
+        group.pending++;
+        Queue& queue = *queues[self()];
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.tasks.push_back([&group, f] {
+                f();
+                group.pending--;
+            });
+        }
+        {
+            // Under sleepMutex, so the count cannot change between a sleeping worker's
+            // check of queued and its wait, where the notify would be lost
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            queued++;
+        }
+        if (!workers.empty()) wake.notify_one();
+    }
+
+    // Run tasks (from any queue) until every task in group has finished
+    void wait(TaskGroup& group) {
+        while (group.pending.load() > 0) {
+            if (!runOne(self())) std::this_thread::yield();
+        }
+    }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    // Index of the calling worker; outside threads share queue 0
+    unsigned self() const { return currentWorker < 0 ? 0 : (unsigned)currentWorker; }
+
+    // Pop the newest local task, else steal the oldest task of another worker
+    bool runOne(unsigned me) {
+        std::function<void()> task;
+        for (unsigned k = 0; k < queues.size() && !task; k++) {
+            unsigned victim = (me + k) % queues.size();
+            Queue& queue = *queues[victim];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (queue.tasks.empty()) continue;
+            if (k == 0) {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+            } else {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+            }
+        }
+        if (!task) return false;
+        queued--;
+        task();
+        return true;
+    }
+
+    void workerLoop(unsigned index) {
+        currentWorker = (int)index;
+        while (true) {
+            if (runOne(index)) continue;
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            wake.wait(lock, [this] { return stopping || queued.load() > 0; });
+            if (stopping) return;
+        }
+    }
+
+    static inline thread_local int currentWorker = -1;
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<int> queued{0};
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    bool stopping = false;
+};
+
+// Combine the statistics of a node's two subtrees into the node's own statistics
+inline TreeStats combineStats(const TreeStats& left, const TreeStats& right) {
+    TreeStats stats;
+    stats.height = 1 + std::max(left.height, right.height);
+    stats.size = 1 + left.size + right.size;
+    stats.leaves = (left.size == 0 && right.size == 0) ? 1 : left.leaves + right.leaves;
+    stats.diameter = std::max({left.diameter, right.diameter, left.height + right.height + 1});
+    stats.balanced = left.balanced && right.balanced && std::abs(left.height - right.height) <= 1;
+    stats.depthCounts.assign(stats.height, 0);
+    stats.depthCounts[0] = 1;
+    for (size_t d = 0; d < left.depthCounts.size(); d++) stats.depthCounts[d + 1] += left.depthCounts[d];
+    for (size_t d = 0; d < right.depthCounts.size(); d++) stats.depthCounts[d + 1] += right.depthCounts[d];
+    return stats;
+}
+
+// Subtrees with fewer nodes than this are walked serially (for nodes that cache sizes)
+const int parallelGrain = 1 << 15;
+
+// Whether to fork the children of node, spawnDepth levels above the depth cap
+template <typename Node>
+inline bool shouldSplit(const Node* node, int spawnDepth) {
+    if (spawnDepth <= 0) return false;
+    if constexpr (Node::augment_type::tracksSize) return node->size >= parallelGrain;
+    return true;
+}
+
+// Parallel computeStats: large subtrees are forked, the rest run serially
+template <typename Node>
+inline TreeStats parallelStats(Node* root, TaskPool& pool, int spawnDepth = 12) {
+    if (!root || !shouldSplit(root, spawnDepth)) return computeStats(root);
+    TreeStats left, right;
+    TaskGroup group;
+    pool.spawn(group, [&] { left = parallelStats(root->left, pool, spawnDepth - 1); });
+    right = parallelStats(root->right, pool, spawnDepth - 1);
+    pool.wait(group);
+    return combineStats(left, right);
+}
+
+// Parallel search of an unordered tree; the first match stops the other tasks
+template <typename Node>
+inline void parallelSearchFrom(Node* root, int key, TaskPool& pool, int spawnDepth, std::atomic<bool>& found) {
+    if (!root || found.load(std::memory_order_relaxed)) return;
+    if (root->data == key) {
+        found = true;
+        return;
+    }
+    if (shouldSplit(root, spawnDepth)) {
+        TaskGroup group;
+        pool.spawn(group, [&] { parallelSearchFrom(root->left, key, pool, spawnDepth - 1, found); });
+        parallelSearchFrom(root->right, key, pool, spawnDepth - 1, found);
+        pool.wait(group);
+        return;
+    }
+
+    std::vector<Node*> stack{root};
+    size_t visited = 0;
+    while (!stack.empty()) {
+        Node* node = stack.back();
+        stack.pop_back();
+        if (node->data == key) {
+            found = true;
+            return;
+        }
+        if ((++visited & 1023) == 0 && found.load(std::memory_order_relaxed)) return;
+        if (node->right) stack.push_back(node->right);
+        if (node->left) stack.push_back(node->left);
+    }
+}
+
+template <typename Node>
+inline bool parallelSearchNode(Node* root, int key, TaskPool& pool, int spawnDepth = 12) {
+    std::atomic<bool> found{false};
+    parallelSearchFrom(root, key, pool, spawnDepth, found);
+    return found.load();
+}
+
+#endif
@@ -0,0 +1,211 @@
+#ifndef PERSISTENT_AVL_TREE_H
+#define PERSISTENT_AVL_TREE_H
+
+// Persistent (immutable) AVL tree.
+// Nodes are never modified once built: insert and erase copy the O(log n) nodes on
+// the search path and rebuild rotations out of new nodes, so every earlier version
+// stays valid and shares all untouched subtrees with the new one. Nodes carry an
+// atomic reference count; a PersistentAVLTree is a cheap handle on one version, and
+// a node is freed when the last version that reaches it is dropped. Handles may be
+// copied to and released on other threads, but one handle must not be modified
+// from two threads at once (like std::shared_ptr).
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <vector>
+
+namespace avl {
+
+struct PersistentAVLNode {
+    int data;
+    int height;
+    int size;
+    mutable std::atomic<int> refs;
+    const PersistentAVLNode* left;
+    const PersistentAVLNode* right;
+};
+
+class PersistentAVLTree {
+public:
+    using Node = PersistentAVLNode;
+
+    PersistentAVLTree() : root(nullptr) {}
+    PersistentAVLTree(const PersistentAVLTree& other) : root(retain(other.root)) {}
+    PersistentAVLTree(PersistentAVLTree&& other) noexcept : root(other.root) { other.root = nullptr; }
+    ~PersistentAVLTree() { release(root); }
+
+    PersistentAVLTree& operator=(PersistentAVLTree other) noexcept {
+        std::swap(root, other.root);
+        return *this;
+    }
+
+    // O(1) point-in-time view; later inserts/erases on this handle do not affect it
+    PersistentAVLTree snapshot() const { return *this; }
+
+    // Insert a key (duplicates are ignored, as in avl::insert)
+    void insert(int key) {
+        if (searchNode(key)) return;
+        replaceRoot(insertAt(root, key));
+    }
+
+    // Erase one occurrence of key; returns false if it was not present
+    bool erase(int key) {
+        if (!searchNode(key)) return false;
+        replaceRoot(eraseAt(root, key));
+        return true;
+    }
+
+    bool searchNode(int key) const {
+        const Node* current = root;
+        while (current) {
+            if (key == current->data) return true;
+            current = (key < current->data) ? current->left : current->right;
+        }
+        return false;
+    }
+
+    // Visit the keys of this version in sorted order
+    template <typename F>
+    void forEach(F visit) const {
+        std::vector<const Node*> stack;
+        const Node* current = root;
+        while (current || !stack.empty()) {
+            while (current) {
+                stack.push_back(current);
+                current = current->left;
+            }
+            current = stack.back();
+            stack.pop_back();
+            visit(current->data);
+            current = current->right;
+        }
+    }
+
+    void inorder() const {
+        forEach([](int key) { std::cout << key << " "; });
+    }
+
+    int size() const { return sizeOf(root); }
+    int height() const { return heightOf(root); }
+
+    // Nodes currently allocated across all versions of all persistent trees
+    static size_t liveNodes() { return liveCount().load(std::memory_order_relaxed); }
+
+private:
+    static std::atomic<size_t>& liveCount() {
+        static std::atomic<size_t> count{0};
+        return count;
+    }
+
+    static int heightOf(const Node* node) { return node ? node->height : 0; }
+    static int sizeOf(const Node* node) { return node ? node->size : 0; }
+
+    static const Node* retain(const Node* node) {
+        if (node) node->refs.fetch_add(1, std::memory_order_relaxed);
+        return node;
+    }
+
+    // Drop one reference; frees the node and, in turn, any children it kept alive
+    static void release(const Node* node) {
+        std::vector<const Node*> stack;
+        while (true) {
+            if (node && node->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                stack.push_back(node->left);
+                stack.push_back(node->right);
+                delete node;
+                liveCount().fetch_sub(1, std::memory_order_relaxed);
+            }
+            if (stack.empty()) return;
+            node = stack.back();
+            stack.pop_back();
+        }
+    }
+
+    void replaceRoot(const Node* updated) {
+        release(root);
+        root = updated;
+    }
+
+    // New node over two subtrees. It takes over the caller's references to left and
+    // right; the caller owns the returned reference.
+    static const Node* make(int data, const Node* left, const Node* right) {
+        liveCount().fetch_add(1, std::memory_order_relaxed);
+        return new Node{data, 1 + std::max(heightOf(left), heightOf(right)), 1 + sizeOf(left) + sizeOf(right), {1},
+                        left, right};
+    }
+
+    // make() for a node that replaces node, consuming the caller's reference to it.
+    // When that is the only reference, node was built during this update and no
+    // version can reach it, so it is rewritten in place instead of copied and freed.
+    static const Node* remake(const Node* node, int data, const Node* left, const Node* right) {
+        if (node->refs.load(std::memory_order_acquire) != 1) {
+            const Node* result = make(data, left, right);
+            release(node);
+            return result;
+        }
+        Node* owned = const_cast<Node*>(node);
+        release(owned->left);
+        release(owned->right);
+        owned->data = data;
+        owned->height = 1 + std::max(heightOf(left), heightOf(right));
+        owned->size = 1 + sizeOf(left) + sizeOf(right);
+        owned->left = left;
+        owned->right = right;
+        return owned;
+    }
+
+    // make() that also rotates when the subtree heights differ by two (consuming the
+    // references to left and right). A rotation never writes a published node: the
+    // nodes it moves are copied, or reused with remake() when this update built them.
+    static const Node* balanced(int data, const Node* left, const Node* right) {
+        int leftHeight = heightOf(left), rightHeight = heightOf(right);
+        if (leftHeight > rightHeight + 1) {
+            if (heightOf(left->left) >= heightOf(left->right)) {
+                // Left Left Case
+                const Node* lower = make(data, retain(left->right), right);
+                return remake(left, left->data, retain(left->left), lower);
+            }
+            // Left Right Case
+            const Node* pivot = retain(left->right);
+            const Node* lowerLeft = remake(left, left->data, retain(left->left), retain(pivot->left));
+            const Node* lowerRight = make(data, retain(pivot->right), right);
+            return remake(pivot, pivot->data, lowerLeft, lowerRight);
+        }
+        if (rightHeight > leftHeight + 1) {
+            if (heightOf(right->right) >= heightOf(right->left)) {
+                // Right Right Case
+                const Node* lower = make(data, left, retain(right->left));
+                return remake(right, right->data, lower, retain(right->right));
+            }
+            // Right Left Case
+            const Node* pivot = retain(right->left);
+            const Node* lowerRight = remake(right, right->data, retain(pivot->right), retain(right->right));
+            const Node* lowerLeft = make(data, left, retain(pivot->left));
+            return remake(pivot, pivot->data, lowerLeft, lowerRight);
+        }
+        return make(data, left, right);
+    }
+
+    static const Node* insertAt(const Node* node, int key) {
+        if (!node) return make(key, nullptr, nullptr);
+        if (key < node->data) return balanced(node->data, insertAt(node->left, key), retain(node->right));
+        return balanced(node->data, retain(node->left), insertAt(node->right, key));
+    }
+
+    // Successor replacement as in avl::erase; key must be present
+    static const Node* eraseAt(const Node* node, int key) {
+        if (key < node->data) return balanced(node->data, eraseAt(node->left, key), retain(node->right));
+        if (key > node->data) return balanced(node->data, retain(node->left), eraseAt(node->right, key));
+        if (!node->left || !node->right) return retain(node->left ? node->left : node->right);
+        const Node* successor = node->right;
+        while (successor->left) successor = successor->left;
+        return balanced(successor->data, retain(node->left), eraseAt(node->right, successor->data));
+    }
+
+    const Node* root;
+};
+
+}  // namespace avl
+
+#endif
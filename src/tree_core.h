@@ -0,0 +1,597 @@
+#ifndef TREE_CORE_H
+#define TREE_CORE_H
+
+// Generic binary tree core shared by the binary tree, BST and AVL headers.
+// Node<Key, Augment> is parameterised on the key type and on an augmentation policy
+// that decides which cached fields a node carries:
+//   NoAugment          nothing (key + two links)
+//   SizeAugment        subtree size (countNodes, order_of_key in O(h))
+//   HeightAugment      subtree height (AVL balancing, findHeight in O(1))
+//   SizeHeightAugment  both, as the AVL tree uses
+// The algorithms take the key comparator as a parameter (std::less by default) and
+// test the policy with if constexpr, so bookkeeping a policy does not track compiles
+// away. Walks use explicit stacks; only the AVL insert recurses (depth O(log n)).
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <queue>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "node_pool.h"
+
+namespace core {
+
+template <typename Node>
+inline int getSize(const Node* node) {
+    return node ? node->size : 0;
+}
+
+template <typename Node>
+inline int getHeight(const Node* node) {
+    return node ? node->height : 0;
+}
+
+struct NoAugment {
+    static constexpr bool tracksSize = false;
+    static constexpr bool tracksHeight = false;
+    template <typename Node>
+    static void update(Node*) {}
+};
+
+struct SizeAugment {
+    static constexpr bool tracksSize = true;
+    static constexpr bool tracksHeight = false;
+    int size = 1;  // To store the size of the subtree
+    template <typename Node>
+    static void update(Node* node) {
+        node->size = 1 + getSize(node->left) + getSize(node->right);
+    }
+};
+
+struct HeightAugment {
+    static constexpr bool tracksSize = false;
+    static constexpr bool tracksHeight = true;
+    int height = 1;
+    template <typename Node>
+    static void update(Node* node) {
+        node->height = 1 + std::max(getHeight(node->left), getHeight(node->right));
+    }
+};
+
+struct SizeHeightAugment {
+    static constexpr bool tracksSize = true;
+    static constexpr bool tracksHeight = true;
+    int height = 1;
+    int size = 1;
+    template <typename Node>
+    static void update(Node* node) {
+        node->height = 1 + std::max(getHeight(node->left), getHeight(node->right));
+        node->size = 1 + getSize(node->left) + getSize(node->right);
+    }
+};
+
+// Tree node structure
+template <typename Key, typename Augment = NoAugment>
+struct Node : Augment {
+    using key_type = Key;
+    using augment_type = Augment;
+
+    Key data;
+    Node* left;
+    Node* right;
+
+    Node(const Key& x) : data(x), left(nullptr), right(nullptr) {}
+};
+
+// Recompute the cached fields of one node from its children
+template <typename N>
+inline void updateNode(N* node) {
+    N::augment_type::update(node);
+}
+
+// Recompute the cached fields of a whole subtree
+// Nodes are collected in preorder and updated in reverse, so every child is
+// finished before its parent without recursing.
+template <typename N>
+inline void updateAugment(N* root) {
+    if constexpr (N::augment_type::tracksSize || N::augment_type::tracksHeight) {
+        if (!root) return;
+        std::vector<N*> order{root};
+        for (size_t i = 0; i < order.size(); i++) {
+            if (order[i]->left) order.push_back(order[i]->left);
+            if (order[i]->right) order.push_back(order[i]->right);
+        }
+        for (size_t i = order.size(); i-- > 0;) updateNode(order[i]);
+    }
+}
+
+// Tree traversal functions; visit(node) is called once per node
+template <typename N, typename F>
+inline void forEachInorder(N* root, F visit) {
+    std::vector<N*> stack;
+    N* current = root;
+    while (current || !stack.empty()) {
+        while (current) {
+            stack.push_back(current);
+            current = current->left;
+        }
+        current = stack.back();
+        stack.pop_back();
+        visit(current);
+        current = current->right;
+    }
+}
+
+template <typename N, typename F>
+inline void forEachPreorder(N* root, F visit) {
+    if (!root) return;
+    std::vector<N*> stack{root};
+    while (!stack.empty()) {
+        N* current = stack.back();
+        stack.pop_back();
+        visit(current);
+        if (current->right) stack.push_back(current->right);
+        if (current->left) stack.push_back(current->left);
+    }
+}
+
+template <typename N, typename F>
+inline void forEachPostorder(N* root, F visit) {
+    std::vector<N*> stack;
+    N* current = root;
+    N* lastVisited = nullptr;
+    while (current || !stack.empty()) {
+        while (current) {
+            stack.push_back(current);
+            current = current->left;
+        }
+        N* top = stack.back();
+        if (top->right && top->right != lastVisited) {
+            current = top->right;
+        } else {
+            visit(top);
+            lastVisited = top;
+            stack.pop_back();
+        }
+    }
+}
+
+template <typename N, typename F>
+inline void forEachLevelOrder(N* root, F visit) {
+    if (!root) return;
+    std::queue<N*> q;
+    q.push(root);
+    while (!q.empty()) {
+        N* current = q.front();
+        q.pop();
+        visit(current);
+        if (current->left) q.push(current->left);
+        if (current->right) q.push(current->right);
+    }
+}
+
+// Inorder iterator (bidirectional, read-only keys)
+// Nodes have no parent links, so the iterator keeps the path from the root to its
+// node. Stepping pushes down a subtree or pops back up, amortised O(1) per key and
+// O(h) at worst; the end iterator has an empty path and remembers the root for --.
+template <typename N>
+class TreeIterator {
+public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = typename N::key_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const value_type*;
+    using reference = const value_type&;
+
+    TreeIterator() : root(nullptr) {}
+    TreeIterator(N* root, std::vector<N*> path) : root(root), path(std::move(path)) {}
+
+    reference operator*() const { return path.back()->data; }
+    pointer operator->() const { return &path.back()->data; }
+    N* node() const { return path.empty() ? nullptr : path.back(); }
+
+    TreeIterator& operator++() {
+        N* current = path.back();
+        if (current->right) {
+            pushLeftSpine(current->right);
+        } else {
+            // Climb until we leave a left subtree; the parent is next
+            path.pop_back();
+            while (!path.empty() && path.back()->right == current) {
+                current = path.back();
+                path.pop_back();
+            }
+        }
+        return *this;
+    }
+
+    TreeIterator& operator--() {
+        if (path.empty()) {
+            pushRightSpine(root);  // --end() is the largest key
+        } else if (path.back()->left) {
+            pushRightSpine(path.back()->left);
+        } else {
+            N* current = path.back();
+            path.pop_back();
+            while (!path.empty() && path.back()->left == current) {
+                current = path.back();
+                path.pop_back();
+            }
+        }
+        return *this;
+    }
+
+    TreeIterator operator++(int) {
+        TreeIterator old = *this;
+        ++*this;
+        return old;
+    }
+
+    TreeIterator operator--(int) {
+        TreeIterator old = *this;
+        --*this;
+        return old;
+    }
+
+    bool operator==(const TreeIterator& other) const { return node() == other.node(); }
+    bool operator!=(const TreeIterator& other) const { return node() != other.node(); }
+
+private:
+    void pushLeftSpine(N* node) {
+        for (; node; node = node->left) path.push_back(node);
+    }
+
+    void pushRightSpine(N* node) {
+        for (; node; node = node->right) path.push_back(node);
+    }
+
+    N* root;
+    std::vector<N*> path;
+};
+
+// A [first, last) pair usable in range-for
+template <typename N>
+struct TreeRange {
+    TreeIterator<N> first, last;
+    TreeIterator<N> begin() const { return first; }
+    TreeIterator<N> end() const { return last; }
+};
+
+template <typename N>
+inline TreeIterator<N> beginInorder(N* root) {
+    std::vector<N*> path;
+    path.reserve(64);
+    for (N* node = root; node; node = node->left) path.push_back(node);
+    return TreeIterator<N>(root, std::move(path));
+}
+
+template <typename N>
+inline TreeIterator<N> endInorder(N* root) {
+    return TreeIterator<N>(root, {});
+}
+
+// First key for which goesLeft(node key) holds, in one root-to-leaf descent: the
+// path is kept down to the last node that qualified.
+template <typename N, typename GoesLeft>
+inline TreeIterator<N> firstWhere(N* root, GoesLeft goesLeft) {
+    std::vector<N*> path;
+    path.reserve(64);  // One allocation covers any AVL tree and most BSTs
+    size_t found = 0;
+    for (N* node = root; node;) {
+        path.push_back(node);
+        if (goesLeft(node->data)) {
+            found = path.size();
+            node = node->left;
+        } else {
+            node = node->right;
+        }
+    }
+    path.resize(found);
+    return TreeIterator<N>(root, std::move(path));
+}
+
+// First key not less than key
+template <typename N, typename Compare = std::less<typename N::key_type>>
+inline TreeIterator<N> lower_bound(N* root, const typename N::key_type& key, Compare comp = Compare()) {
+    return firstWhere(root, [&](const typename N::key_type& data) { return !comp(data, key); });
+}
+
+// First key greater than key
+template <typename N, typename Compare = std::less<typename N::key_type>>
+inline TreeIterator<N> upper_bound(N* root, const typename N::key_type& key, Compare comp = Compare()) {
+    return firstWhere(root, [&](const typename N::key_type& data) { return comp(key, data); });
+}
+
+// Keys in the closed range [lo, hi], in order: O(log n) to set up plus O(1) amortised per key
+template <typename N, typename Compare = std::less<typename N::key_type>>
+inline TreeRange<N> range(N* root, const typename N::key_type& lo, const typename N::key_type& hi,
+                          Compare comp = Compare()) {
+    if (comp(hi, lo)) return {endInorder(root), endInorder(root)};
+    return {lower_bound(root, lo, comp), upper_bound(root, hi, comp)};
+}
+
+// Search an ordered tree (BST or AVL)
+// Both comparisons are evaluated without short-circuiting, so the only branch is
+// the rarely taken equality exit and the child is picked with a conditional move,
+// as in the hand-written int search (a short-circuit && compiles to two branches).
+template <typename N, typename Compare = std::less<typename N::key_type>>
+inline bool searchNode(const N* root, const typename N::key_type& key, Compare comp = Compare()) {
+    while (root) {
+        bool less = comp(key, root->data), greater = comp(root->data, key);
+        if (!(less | greater)) return true;
+        root = less ? root->left : root->right;
+    }
+    return false;
+}
+
+// Search an unordered tree: preorder, left subtree first
+template <typename N>
+inline bool searchUnordered(N* root, const typename N::key_type& key) {
+    if (!root) return false;
+    std::vector<N*> stack{root};
+    while (!stack.empty()) {
+        N* current = stack.back();
+        stack.pop_back();
+        if (current->data == key) return true;
+        if (current->right) stack.push_back(current->right);
+        if (current->left) stack.push_back(current->left);
+    }
+    return false;
+}
+
+// Function to find the height of the tree
+// O(1) when heights are cached, otherwise counts levels breadth-first.
+template <typename N>
+inline int findHeight(N* root) {
+    if constexpr (N::augment_type::tracksHeight) {
+        return getHeight(root);
+    } else {
+        if (!root) return 0;
+        int height = 0;
+        std::vector<N*> level{root}, next;
+        while (!level.empty()) {
+            height++;
+            next.clear();
+            for (N* node : level) {
+                if (node->left) next.push_back(node->left);
+                if (node->right) next.push_back(node->right);
+            }
+            level.swap(next);
+        }
+        return height;
+    }
+}
+
+// Function to count the total nodes; O(1) when sizes are cached
+template <typename N>
+inline int countNodes(N* root) {
+    if constexpr (N::augment_type::tracksSize) {
+        return getSize(root);
+    } else {
+        int count = 0;
+        forEachPreorder(root, [&](N*) { count++; });
+        return count;
+    }
+}
+
+// Function to count leaf nodes
+template <typename N>
+inline int countLeafNodes(N* root) {
+    int leaves = 0;
+    std::vector<N*> stack;
+    stack.reserve(64);
+    while (root || !stack.empty()) {
+        if (!root) {
+            root = stack.back();
+            stack.pop_back();
+        }
+        if (!root->left && !root->right) leaves++;
+        if (root->right) stack.push_back(root->right);
+        root = root->left;
+    }
+    return leaves;
+}
+
+// Function to find the diameter (in nodes) of the tree; returns the height
+// Same walk as forEachPostorder; finished subtree heights are passed up on a second stack.
+template <typename N>
+inline int findDiameter(N* root, int& diameter) {
+    if (!root) return 0;
+    std::vector<N*> stack;
+    std::vector<int> heights;
+    stack.reserve(64);
+    heights.reserve(64);
+    N* current = root;
+    N* lastVisited = nullptr;
+    while (current || !stack.empty()) {
+        while (current) {
+            stack.push_back(current);
+            current = current->left;
+        }
+        N* top = stack.back();
+        if (top->right && top->right != lastVisited) {
+            current = top->right;
+            continue;
+        }
+        int rightHeight = 0, leftHeight = 0;
+        if (top->right) { rightHeight = heights.back(); heights.pop_back(); }
+        if (top->left) { leftHeight = heights.back(); heights.pop_back(); }
+        diameter = std::max(diameter, leftHeight + rightHeight + 1);
+        heights.push_back(std::max(leftHeight, rightHeight) + 1);
+        lastVisited = top;
+        stack.pop_back();
+    }
+    return heights.back();
+}
+
+// BST insertion function
+// Every key is inserted (equal keys go right). Sizes are bumped on the way down;
+// cached heights are recomputed back up the path. The descent is a loop, so sorted
+// input cannot overflow the native stack.
+template <typename N, typename Compare = std::less<typename N::key_type>>
+inline N* insertBST(N* root, const typename N::key_type& key, NodePool<N>* pool = nullptr, Compare comp = Compare()) {
+    if (!root) return newNode(pool, key);
+
+    std::vector<N*> path;
+    N* current = root;
+    while (true) {
+        if constexpr (N::augment_type::tracksSize) current->size++;
+        if constexpr (N::augment_type::tracksHeight) path.push_back(current);
+        N*& next = comp(key, current->data) ? current->left : current->right;
+        if (!next) {
+            next = newNode(pool, key);
+            break;
+        }
+        current = next;
+    }
+    if constexpr (N::augment_type::tracksHeight) {
+        for (size_t i = path.size(); i-- > 0;) {
+            int height = 1 + std::max(getHeight(path[i]->left), getHeight(path[i]->right));
+            if (path[i]->height == height) break;  // Ancestors are unchanged too
+            path[i]->height = height;
+        }
+    }
+    return root;
+}
+
+// Function to find the number of keys less than the given key
+template <typename N, typename Compare = std::less<typename N::key_type>>
+inline int order_of_key(const N* root, const typename N::key_type& key, Compare comp = Compare()) {
+    static_assert(N::augment_type::tracksSize, "order_of_key needs cached subtree sizes");
+    int order = 0;
+    while (root) {
+        if (!comp(root->data, key)) {
+            root = root->left;
+        } else {
+            order += getSize(root->left) + 1;
+            root = root->right;
+        }
+    }
+    return order;
+}
+
+// Function to find the number of keys less than or equal to the given key
+template <typename N, typename Compare = std::less<typename N::key_type>>
+inline int count_not_greater(const N* root, const typename N::key_type& key, Compare comp = Compare()) {
+    static_assert(N::augment_type::tracksSize, "count_not_greater needs cached subtree sizes");
+    int count = 0;
+    while (root) {
+        if (comp(key, root->data)) {
+            root = root->left;
+        } else {
+            count += getSize(root->left) + 1;
+            root = root->right;
+        }
+    }
+    return count;
+}
+
+// Function to find the k-th smallest key's node (0-based, like order_of_key); nullptr if out of range
+template <typename N>
+inline N* find_by_order(N* root, int k) {
+    static_assert(N::augment_type::tracksSize, "find_by_order needs cached subtree sizes");
+    if (k < 0 || k >= getSize(root)) return nullptr;
+    while (root) {
+        int leftSize = getSize(root->left);
+        if (k < leftSize) {
+            root = root->left;
+        } else if (k == leftSize) {
+            return root;
+        } else {
+            k -= leftSize + 1;
+            root = root->right;
+        }
+    }
+    return nullptr;
+}
+
+// AVL rotations; the cached fields of the two moved nodes are recomputed
+template <typename N>
+inline N* rightRotate(N* y) {
+    N* x = y->left;
+    y->left = x->right;
+    x->right = y;
+    updateNode(y);
+    updateNode(x);
+    return x;
+}
+
+template <typename N>
+inline N* leftRotate(N* x) {
+    N* y = x->right;
+    x->right = y->left;
+    y->left = x;
+    updateNode(x);
+    updateNode(y);
+    return y;
+}
+
+// Restore the AVL property at node (whose cached fields are current) after one of
+// its subtrees grew or shrank by one level. The case is picked from the child's
+// balance factor, so no key is needed.
+template <typename N>
+inline N* rebalance(N* node) {
+    static_assert(N::augment_type::tracksHeight, "AVL balancing needs cached heights");
+    int balance = getHeight(node->left) - getHeight(node->right);
+
+    if (balance > 1) {
+        if (getHeight(node->left->left) < getHeight(node->left->right))
+            node->left = leftRotate(node->left);  // Left Right Case
+        return rightRotate(node);                 // Left Left Case
+    }
+
+    if (balance < -1) {
+        if (getHeight(node->right->right) < getHeight(node->right->left))
+            node->right = rightRotate(node->right);  // Right Left Case
+        return leftRotate(node);                     // Right Right Case
+    }
+
+    return node;
+}
+
+// AVL insertion (duplicates are ignored)
+template <typename N, typename Compare = std::less<typename N::key_type>>
+inline N* insertAVL(N* node, const typename N::key_type& key, NodePool<N>* pool = nullptr, Compare comp = Compare()) {
+    static_assert(N::augment_type::tracksHeight, "AVL balancing needs cached heights");
+    if (node == nullptr) return newNode(pool, key);
+
+    if (comp(key, node->data))
+        node->left = insertAVL(node->left, key, pool, comp);
+    else if (comp(node->data, key))
+        node->right = insertAVL(node->right, key, pool, comp);
+    else
+        return node;  // Duplicate keys not allowed
+
+    updateNode(node);
+    int balance = getHeight(node->left) - getHeight(node->right);
+
+    // Left Left Case
+    if (balance > 1 && comp(key, node->left->data))
+        return rightRotate(node);
+
+    // Right Right Case
+    if (balance < -1 && comp(node->right->data, key))
+        return leftRotate(node);
+
+    // Left Right Case
+    if (balance > 1 && comp(node->left->data, key)) {
+        node->left = leftRotate(node->left);
+        return rightRotate(node);
+    }
+
+    // Right Left Case
+    if (balance < -1 && comp(key, node->right->data)) {
+        node->right = rightRotate(node->right);
+        return leftRotate(node);
+    }
+
+    return node;
+}
+
+}  // namespace core
+
+#endif
@@ -0,0 +1,156 @@
+#ifndef TREE_LAYOUT_H
+#define TREE_LAYOUT_H
+
+// Node placement for the visualizers.
+// Every node gets a column of its own, its inorder rank, and the row of its depth,
+// so no two nodes overlap however deep the tree is: nodes next to each other in
+// inorder are always ancestor and descendant, so nodes on one row are at least two
+// columns apart. The layout is a vector of (node, depth) slots in inorder; a
+// node's children sit at columns derived from the cached subtree sizes, so drawing
+// is a single walk over the slots with no height queries and no pow.
+//
+// build() lays out a whole tree in one O(n) pass. inserted() updates the layout of
+// an ordered tree (BST or AVL) after an insert without a full pass: the new slot is
+// spliced in at the key's rank, which moves every later column over by one, and if
+// a rotation changed depths on the way back up, only the rotated subtree (which
+// hangs off the insertion path) is laid out again.
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "tree_core.h"
+
+namespace core {
+
+template <typename N>
+class TreeLayout {
+    static_assert(N::augment_type::tracksSize, "the layout reads child columns from cached subtree sizes");
+
+public:
+    struct Slot {
+        N* node;
+        int depth;  // Row, the root is 0
+    };
+
+    // Lay out the whole tree: one iterative inorder walk
+    void build(N* root) {
+        slots.clear();
+        layoutSubtree(root, 0, 0);
+    }
+
+    // Update the layout after key was inserted into the ordered tree rooted at root
+    // (equal keys to the right, as in insertBST). O(h + k) for a rotated subtree of
+    // k nodes, plus the splice, which is a memmove of the later slots.
+    template <typename Compare = std::less<typename N::key_type>>
+    void inserted(N* root, const typename N::key_type& key, Compare comp = Compare()) {
+        if ((int)slots.size() == getSize(root)) return;  // Duplicate ignored by the AVL tree
+        if ((int)slots.size() + 1 != getSize(root)) {
+            build(root);  // The layout was not in step with the tree before this insert
+            return;
+        }
+        struct Step {
+            N* node;
+            int rank, depth;
+        };
+        std::vector<Step> path;
+        int before = 0, target = -1;  // before: nodes left of the current subtree
+        for (N* node = root; node;) {
+            int rank = before + getSize(node->left);
+            path.push_back({node, rank, (int)path.size()});
+            bool left = comp(key, node->data);
+            if (!left && !comp(node->data, key)) target = (int)path.size() - 1;  // Last equal node is the new one
+            if (left) {
+                node = node->left;
+            } else {
+                before = rank + 1;
+                node = node->right;
+            }
+        }
+        if (target < 0) return;
+
+        // Depth -1 never matches, so the walk below always reaches the new node
+        slots.insert(slots.begin() + path[target].rank, Slot{path[target].node, -1});
+        for (const Step& step : path) {
+            const Slot& slot = slots[step.rank];
+            if (slot.node != step.node || slot.depth != step.depth) {
+                layoutSubtree(step.node, step.rank - getSize(step.node->left), step.depth);
+                return;
+            }
+        }
+    }
+
+    int size() const { return (int)slots.size(); }
+    const Slot& slot(int column) const { return slots[column]; }
+    int width() const { return (int)slots.size(); }
+    int rootColumn(N* root) const { return getSize(root ? root->left : nullptr); }
+
+    // Columns of a node's children (only meaningful when the child exists)
+    int leftColumn(int column) const {
+        N* node = slots[column].node;
+        return column - 1 - getSize(node->left->right);
+    }
+
+    int rightColumn(int column) const {
+        N* node = slots[column].node;
+        return column + 1 + getSize(node->right->left);
+    }
+
+    // Visit (node, column, depth) in column order
+    template <typename F>
+    void forEach(F visit) const {
+        for (int column = 0; column < (int)slots.size(); column++) visit(slots[column].node, column, slots[column].depth);
+    }
+
+private:
+    // Write the slots of the subtree at node, whose leftmost column is first
+    void layoutSubtree(N* node, int first, int depth) {
+        std::vector<std::pair<N*, int>> stack;
+        int column = first;
+        while (node || !stack.empty()) {
+            while (node) {
+                stack.push_back({node, depth++});
+                node = node->left;
+            }
+            std::pair<N*, int> top = stack.back();
+            stack.pop_back();
+            if (column == (int)slots.size()) slots.push_back({top.first, top.second});
+            else slots[column] = {top.first, top.second};
+            column++;
+            node = top.first->right;
+            depth = top.second + 1;
+        }
+    }
+
+    std::vector<Slot> slots;
+};
+
+// Maps layout columns and rows to window pixels
+// The root stays at (rootX, rootY); columns are spaced so both sides of the tree fit
+// in width pixels centred on it, but never narrower than minColumn, the spacing at
+// which nodes on one row still do not touch (wider trees run off the window rather
+// than overlap). Columns may be narrower than a pixel (a whole large tree fitted into
+// one image). A node's column only depends on the cached sizes, so the viewport is
+// fitted to the tree itself and matches any layout that is in step with it.
+struct Viewport {
+    int rootX, rootY;
+    double columnWidth;
+    int rowHeight, rootColumn;
+
+    template <typename N>
+    static Viewport fit(N* root, int rootX, int rootY, int width, int rowHeight, double minColumn, double maxColumn) {
+        int rootColumn = getSize(root ? root->left : nullptr);
+        int side = std::max(rootColumn, getSize(root) - 1 - rootColumn);  // Columns on the wider side
+        double columnWidth = std::max(minColumn, std::min(maxColumn, (double)width / (2 * side + 1)));
+        return {rootX, rootY, columnWidth, rowHeight, rootColumn};
+    }
+
+    int x(int column) const { return rootX + (int)std::lround((column - rootColumn) * columnWidth); }
+    int y(int depth) const { return rootY + depth * rowHeight; }
+};
+
+}  // namespace core
+
+#endif
@@ -0,0 +1,227 @@
+#ifndef TREE_MAP_H
+#define TREE_MAP_H
+
+// Key -> value map mode for the BST and AVL trees.
+// MapNode is a tree_core node that also carries a value, so a payload lives in the
+// tree node instead of in a side hash map that would need a second lookup.
+// TreeMap owns its nodes and offers the std::map style emplace / try_emplace
+// (values may be move-only) plus upsert, which inserts or assigns in one descent.
+// With a transparent comparator (std::less<> by default) find, contains and the
+// inserting calls accept any type comparable with Key, so e.g. a std::string_view
+// looks up std::string keys without building a temporary string; the key is only
+// constructed when a new node is made. Other comparators get a converted Key.
+// bst::TreeMap leaves the tree unbalanced; avl::TreeMap rebalances on the way back
+// up the recorded descent path, exactly as avl::insert does on its recursion.
+
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "tree_core.h"
+
+namespace core {
+
+// Map node structure: the key stays in data so the core algorithms apply unchanged
+template <typename Key, typename Value, typename Augment = SizeHeightAugment>
+struct MapNode : Augment {
+    using key_type = Key;
+    using mapped_type = Value;
+    using augment_type = Augment;
+
+    Key data;
+    Value value;
+    MapNode* left;
+    MapNode* right;
+
+    template <typename K, typename... Args>
+    MapNode(K&& key, Args&&... args)
+        : data(std::forward<K>(key)), value(std::forward<Args>(args)...), left(nullptr), right(nullptr) {}
+};
+
+template <typename Compare, typename = void>
+struct isTransparent : std::false_type {};
+
+template <typename Compare>
+struct isTransparent<Compare, std::void_t<typename Compare::is_transparent>> : std::true_type {};
+
+template <typename Key, typename Value, typename Compare = std::less<>, bool Balanced = true>
+class TreeMap {
+public:
+    using Node = MapNode<Key, Value, std::conditional_t<Balanced, SizeHeightAugment, SizeAugment>>;
+
+    TreeMap(Compare comp = Compare()) : root(nullptr), comp(comp) {}
+    TreeMap(const TreeMap&) = delete;
+    TreeMap& operator=(const TreeMap&) = delete;
+    ~TreeMap() { clear(); }
+
+    // Insert key with a value built from args unless the key is present; args are
+    // left untouched then. Returns the node holding key and whether it was inserted.
+    template <typename K, typename... Args>
+    std::pair<Node*, bool> try_emplace(K&& key, Args&&... args) {
+        Node** link = descend(key);
+        if (*link) return {*link, false};
+        Node* node = new Node(std::forward<K>(key), std::forward<Args>(args)...);
+        attach(link, node);
+        return {node, true};
+    }
+
+    // Build the node first (as std::map::emplace does) and discard it if the key is present
+    template <typename... Args>
+    std::pair<Node*, bool> emplace(Args&&... args) {
+        Node* node = new Node(std::forward<Args>(args)...);
+        Node** link = descend(node->data);
+        if (*link) {
+            delete node;
+            return {*link, false};
+        }
+        attach(link, node);
+        return {node, true};
+    }
+
+    // Insert key -> value, or assign value if key is present; one descent either way.
+    // Returns true if a new node was inserted.
+    template <typename K, typename V>
+    bool upsert(K&& key, V&& value) {
+        Node** link = descend(key);
+        if (*link) {
+            (*link)->value = std::forward<V>(value);
+            return false;
+        }
+        attach(link, new Node(std::forward<K>(key), std::forward<V>(value)));
+        return true;
+    }
+
+    // Value for key, default-constructed and inserted first if missing
+    template <typename K>
+    Value& operator[](K&& key) {
+        return try_emplace(std::forward<K>(key)).first->value;
+    }
+
+    // Value for key, or nullptr if it is not present
+    template <typename K>
+    Value* find(const K& key) {
+        Node* node = findNode(key);
+        return node ? &node->value : nullptr;
+    }
+
+    template <typename K>
+    const Value* find(const K& key) const {
+        const Node* node = findNode(key);
+        return node ? &node->value : nullptr;
+    }
+
+    template <typename K>
+    bool contains(const K& key) const {
+        return findNode(key) != nullptr;
+    }
+
+    // Visit (key, value) pairs in key order
+    template <typename F>
+    void forEach(F visit) const {
+        forEachInorder(root, [&](Node* node) { visit(node->data, node->value); });
+    }
+
+    void clear() {
+        forEachPostorder(root, [](Node* node) { delete node; });
+        root = nullptr;
+    }
+
+    int size() const { return getSize(root); }
+    int height() const { return findHeight(root); }
+    Node* getRoot() const { return root; }
+
+private:
+    // The key to compare with: key itself under a transparent comparator, else a Key built from it
+    template <typename K>
+    decltype(auto) lookupKey(const K& key) const {
+        if constexpr (isTransparent<Compare>::value || std::is_same<K, Key>::value) return (key);
+        else return Key(key);
+    }
+
+    // Arithmetic keys make both comparisons and pick the child with a select, as
+    // core::searchNode does; costlier keys (strings) compare once on most levels.
+    static constexpr bool selectStep = std::is_arithmetic<Key>::value;
+
+    template <typename K>
+    Node* findNode(const K& lookup) const {
+        const auto& key = lookupKey(lookup);
+        Node* current = root;
+        while (current) {
+            if constexpr (selectStep) {
+                bool less = comp(key, current->data), greater = comp(current->data, key);
+                if (!(less | greater)) return current;
+                current = less ? current->left : current->right;
+            } else {
+                if (comp(key, current->data)) current = current->left;
+                else if (comp(current->data, key)) current = current->right;
+                else return current;
+            }
+        }
+        return nullptr;
+    }
+
+    // Walk down to the link that holds key (or the null link where it belongs),
+    // recording the links to the nodes passed on the way for attach (a found key's
+    // own link is recorded too, but attach is only called on a miss)
+    template <typename K>
+    Node** descend(const K& lookup) {
+        const auto& key = lookupKey(lookup);
+        path.clear();
+        Node** link = &root;
+        while (Node* current = *link) {
+            path.push_back(link);
+            if constexpr (selectStep) {
+                bool less = comp(key, current->data), greater = comp(current->data, key);
+                if (!(less | greater)) break;
+                link = less ? &current->left : &current->right;
+            } else {
+                if (comp(key, current->data)) link = &current->left;
+                else if (comp(current->data, key)) link = &current->right;
+                else break;
+            }
+        }
+        return link;
+    }
+
+    // Hang node on the null link found by descend, then fix the ancestors bottom-up.
+    // In the AVL map heights are recomputed and rebalanced only until a subtree comes
+    // out as tall as before; every ancestor above that just gains one in size. Nodes
+    // never move, so the recorded links stay valid while rotations relink subtrees.
+    void attach(Node** link, Node* node) {
+        *link = node;
+        size_t i = path.size();
+        if constexpr (Balanced) {
+            for (; i > 0; i--) {
+                Node* ancestor = *path[i - 1];
+                int height = ancestor->height;
+                updateNode(ancestor);
+                *path[i - 1] = rebalance(ancestor);
+                if ((*path[i - 1])->height == height) {
+                    i--;
+                    break;
+                }
+            }
+        }
+        for (; i > 0; i--) (*path[i - 1])->size++;
+    }
+
+    Node* root;
+    Compare comp;
+    std::vector<Node**> path;  // Reused by every descent
+};
+
+}  // namespace core
+
+namespace bst {
+template <typename Key, typename Value, typename Compare = std::less<>>
+using TreeMap = core::TreeMap<Key, Value, Compare, false>;
+}  // namespace bst
+
+namespace avl {
+template <typename Key, typename Value, typename Compare = std::less<>>
+using TreeMap = core::TreeMap<Key, Value, Compare, true>;
+}  // namespace avl
+
+#endif
@@ -0,0 +1,261 @@
+#ifndef TREE_REDRAW_H
+#define TREE_REDRAW_H
+
+// Incremental redraw for the visualizers.
+// A frame is first recorded into a DisplayList (it has the same drawing calls as the
+// canvases in tree_render.h, so renderTree can record into it too). Redrawer keeps
+// the list on screen and, when the next frame is presented, compares the two: only
+// the rectangles covered by primitives that appeared, disappeared or moved are
+// cleared and repainted (clipped, from the new list), so an insert repaints the
+// nodes and edges along its path, the rotated subtree and whatever its new column
+// shifted, not the whole window. Frames that change most of the screen (the first
+// one, a new zoom) are repainted whole.
+//
+// FramePacer replaces the fixed delay() after every insert: a frame is drawn only
+// when one is due at the frame rate and nothing ever sleeps, so inserts that arrive
+// faster than that (piped input) are coalesced into the next frame.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <tuple>
+#include <vector>
+
+namespace core {
+
+// Inclusive pixel rectangle
+struct Rect {
+    int x0, y0, x1, y1;
+
+    bool intersects(const Rect& r) const { return x0 <= r.x1 && r.x0 <= x1 && y0 <= r.y1 && r.y0 <= y1; }
+    Rect unite(const Rect& r) const {
+        return {std::min(x0, r.x0), std::min(y0, r.y0), std::max(x1, r.x1), std::max(y1, r.y1)};
+    }
+    long long area() const { return (long long)(x1 - x0 + 1) * (y1 - y0 + 1); }
+};
+
+// One recorded drawing call
+struct DrawOp {
+    enum Kind : uint8_t { LINE, FILL_RECT, FILL_CIRCLE, CIRCLE, TEXT };
+
+    Kind kind;
+    int a, b, c, d;  // LINE: endpoints; FILL_RECT: x, y, width, height; circles: cx, cy, r; TEXT: x, y, width, height
+    uint32_t color;
+    char text[12];  // TEXT only (labels are numbers, INT_MIN fits); longer strings are cut
+
+    Rect bounds() const {
+        switch (kind) {
+            case LINE: return {std::min(a, c), std::min(b, d), std::max(a, c), std::max(b, d)};
+            case FILL_RECT:
+            case TEXT: return {a, b, a + c - 1, b + d - 1};
+            default: return {a - c, b - c, a + c, b + c};
+        }
+    }
+
+    bool operator<(const DrawOp& o) const {
+        if (std::tie(kind, a, b, c, d, color) != std::tie(o.kind, o.a, o.b, o.c, o.d, o.color))
+            return std::tie(kind, a, b, c, d, color) < std::tie(o.kind, o.a, o.b, o.c, o.d, o.color);
+        return std::strcmp(text, o.text) < 0;
+    }
+};
+
+// Records drawing calls instead of drawing. Colours are passed to the screen as they
+// are (BGI colour numbers for the visualizers, 0xRRGGBB for a Framebuffer); text is
+// measured with a fixed-width font of charWidth x charHeight (BGI's default is 8x8).
+class DisplayList {
+public:
+    DisplayList(int width, int height, int charWidth = 8, int charHeight = 8)
+        : w(width), h(height), charWidth(charWidth), charHeight(charHeight) {}
+
+    int width() const { return w; }
+    int height() const { return h; }
+    uint32_t background() const { return backgroundColor; }
+    const std::vector<DrawOp>& items() const { return ops; }
+
+    // Start a new frame
+    void clear(uint32_t color) {
+        ops.clear();
+        backgroundColor = color;
+    }
+
+    void fillRect(int x, int y, int width, int height, uint32_t color) { add(DrawOp::FILL_RECT, x, y, width, height, color); }
+    void fillCircle(int cx, int cy, int r, uint32_t color) { add(DrawOp::FILL_CIRCLE, cx, cy, r, 0, color); }
+    void circle(int cx, int cy, int r, uint32_t color) { add(DrawOp::CIRCLE, cx, cy, r, 0, color); }
+    void line(int x0, int y0, int x1, int y1, uint32_t color) { add(DrawOp::LINE, x0, y0, x1, y1, color); }
+
+    void text(int x, int y, const char* str, uint32_t color) {
+        add(DrawOp::TEXT, x, y, textWidth(str), charHeight, color);
+        std::snprintf(ops.back().text, sizeof ops.back().text, "%s", str);  // Always terminated
+    }
+
+    int textWidth(const char* str) const { return (int)std::strlen(str) * charWidth; }
+    int textHeight() const { return charHeight; }
+
+    // Draw the recorded calls on screen, in order; with area, only those that touch it
+    template <typename Screen>
+    void replay(Screen& screen, const Rect* area = nullptr) const {
+        for (const DrawOp& op : ops) {
+            if (area && !op.bounds().intersects(*area)) continue;
+            switch (op.kind) {
+                case DrawOp::LINE: screen.line(op.a, op.b, op.c, op.d, op.color); break;
+                case DrawOp::FILL_RECT: screen.fillRect(op.a, op.b, op.c, op.d, op.color); break;
+                case DrawOp::FILL_CIRCLE: screen.fillCircle(op.a, op.b, op.c, op.color); break;
+                case DrawOp::CIRCLE: screen.circle(op.a, op.b, op.c, op.color); break;
+                case DrawOp::TEXT: screen.text(op.a, op.b, op.text, op.color); break;
+            }
+        }
+    }
+
+    // Exchange the recorded frames (size and font metrics stay with each list)
+    void swap(DisplayList& other) {
+        std::swap(backgroundColor, other.backgroundColor);
+        ops.swap(other.ops);
+    }
+
+private:
+    void add(DrawOp::Kind kind, int a, int b, int c, int d, uint32_t color) {
+        DrawOp op;
+        op.kind = kind, op.a = a, op.b = b, op.c = c, op.d = d, op.color = color;
+        op.text[0] = '\0';
+        ops.push_back(op);
+    }
+
+    int w, h, charWidth, charHeight;
+    uint32_t backgroundColor = 0;
+    std::vector<DrawOp> ops;
+};
+
+struct RedrawStats {
+    bool full = false;      // The whole screen was repainted
+    int rects = 0;          // Damaged rectangles repainted
+    int ops = 0;            // Drawing calls replayed
+    long long pixels = 0;   // Area repainted
+};
+
+// Keeps the last presented frame and repaints only what the next one changes.
+// The screen needs the DisplayList drawing calls plus clear(color),
+// setClip(x0, y0, x1, y1) and clearClip().
+class Redrawer {
+public:
+    // Repaint everything once the damaged area exceeds fullShare of the screen
+    explicit Redrawer(double fullShare = 0.5) : fullShare(fullShare), current(0, 0) {}
+
+    // Repaint everything on the next present (e.g. after the window was drawn over)
+    void invalidate() { hasFrame = false; }
+
+    // Bring the screen from the previous frame to next. next is left holding the
+    // previous frame, so the caller can clear and record into it again.
+    template <typename Screen>
+    RedrawStats present(DisplayList& next, Screen& screen) {
+        RedrawStats stats;
+        long long screenArea = (long long)next.width() * next.height();
+        bool full = !hasFrame || next.width() != width || next.height() != height ||
+                    next.background() != current.background();
+        if (!full) {
+            findDamage(next);
+            for (const Rect& r : damage) stats.pixels += r.area();
+            full = stats.pixels > fullShare * screenArea;
+        }
+
+        if (full) {
+            screen.clearClip();
+            screen.clear(next.background());
+            next.replay(screen);
+            stats.full = true;
+            stats.rects = 1;
+            stats.ops = (int)next.items().size();
+            stats.pixels = screenArea;
+        } else {
+            for (const Rect& r : damage) {
+                screen.setClip(r.x0, r.y0, r.x1, r.y1);
+                screen.fillRect(r.x0, r.y0, r.x1 - r.x0 + 1, r.y1 - r.y0 + 1, next.background());
+                next.replay(screen, &r);
+                for (const DrawOp& op : next.items()) stats.ops += op.bounds().intersects(r);
+            }
+            screen.clearClip();
+            stats.rects = (int)damage.size();
+        }
+        current.swap(next);
+        width = next.width(), height = next.height();
+        hasFrame = true;
+        return stats;
+    }
+
+private:
+    // Rectangles around the calls in only one of the two frames, merged where they
+    // overlap. Calls present in both are compared as a multiset, so the frame may be
+    // recorded in any order; a change of stacking order alone is not detected.
+    void findDamage(const DisplayList& next) {
+        before.assign(current.items().begin(), current.items().end());
+        after.assign(next.items().begin(), next.items().end());
+        std::sort(before.begin(), before.end());
+        std::sort(after.begin(), after.end());
+        damage.clear();
+        Rect screen = {0, 0, next.width() - 1, next.height() - 1};
+        size_t i = 0, j = 0;
+        while (i < before.size() || j < after.size()) {
+            if (j == after.size() || (i < before.size() && before[i] < after[j])) {
+                addDamage(before[i++].bounds(), screen);
+            } else if (i == before.size() || after[j] < before[i]) {
+                addDamage(after[j++].bounds(), screen);
+            } else {
+                i++, j++;
+            }
+        }
+    }
+
+    void addDamage(Rect r, const Rect& screen) {
+        if (!r.intersects(screen)) return;
+        r = {std::max(r.x0, screen.x0), std::max(r.y0, screen.y0), std::min(r.x1, screen.x1), std::min(r.y1, screen.y1)};
+        for (size_t k = 0; k < damage.size();) {
+            if (damage[k].intersects(r)) {
+                r = r.unite(damage[k]);
+                damage[k] = damage.back();
+                damage.pop_back();
+                k = 0;  // The grown rectangle may now touch one already passed
+            } else {
+                k++;
+            }
+        }
+        damage.push_back(r);
+        if (damage.size() > maxRects) {
+            Rect all = damage[0];
+            for (const Rect& d : damage) all = all.unite(d);
+            damage.assign(1, all);
+        }
+    }
+
+    static const size_t maxRects = 32;
+
+    double fullShare;
+    bool hasFrame = false;
+    int width = 0, height = 0;  // Of the frame on screen
+    DisplayList current;
+    std::vector<DrawOp> before, after;
+    std::vector<Rect> damage;
+};
+
+// Frame clock that never sleeps: a frame is due once interval has passed since the
+// last one was drawn
+class FramePacer {
+public:
+    explicit FramePacer(int framesPerSecond = 30) : interval(std::chrono::nanoseconds(1000000000LL / framesPerSecond)) {}
+
+    bool due() const { return !drawnOnce || std::chrono::steady_clock::now() - last >= interval; }
+
+    void drawn() {
+        last = std::chrono::steady_clock::now();
+        drawnOnce = true;
+    }
+
+private:
+    std::chrono::nanoseconds interval;
+    std::chrono::steady_clock::time_point last;
+    bool drawnOnce = false;
+};
+
+}  // namespace core
+
+#endif
@@ -0,0 +1,313 @@
+#ifndef TREE_RENDER_H
+#define TREE_RENDER_H
+
+// Offscreen rendering of a tree, for machines without a display.
+// Framebuffer draws into memory and writes a binary PPM; SvgCanvas streams SVG to a
+// file. renderTree places nodes as TreeLayout does (column = inorder rank from the
+// cached subtree sizes, row = depth) but walks the tree top down, so it needs no
+// layout and its cost follows what is on screen rather than the size of the tree:
+//   - culling: a subtree whose columns all lie off the frame, or that starts below
+//     it, is skipped whole
+//   - level of detail: once columns are narrower than the node radius (so nodes on
+//     a row could overlap), a subtree narrower on screen than lodPixels is drawn as
+//     one aggregate glyph (a box over its columns, labelled with its node count when
+//     the label fits) instead of node by node
+// Circles are filled span by span; nothing floods pixels the way BGI's floodfill does.
+//
+// Any type with the Framebuffer drawing calls (clear, fillRect, fillCircle, circle,
+// line, text, textWidth, width, height) can be passed to renderTree as the canvas.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "tree_core.h"
+#include "tree_layout.h"
+
+namespace core {
+
+// Colours are 0xRRGGBB, as COLOR() builds them in graphics.h
+struct RenderStyle {
+    int radius = 20;
+    uint32_t background = 0xA8A8A8;  // LIGHTGRAY
+    uint32_t nodeFill = 0x90EE90;    // The BST visualizer's light green
+    uint32_t nodeBorder = 0xFF0000;
+    uint32_t text = 0x000000;
+    uint32_t edge = 0xFFFF00;
+    uint32_t aggregate = 0x6495ED;
+    int lodPixels = 40;  // Subtrees narrower than this on screen are collapsed (in dense views)
+};
+
+struct RenderStats {
+    int nodes = 0;       // Drawn one by one
+    int aggregates = 0;  // Glyphs drawn for collapsed subtrees
+    int collapsed = 0;   // Nodes inside those subtrees
+    int culled = 0;      // Nodes in subtrees skipped as off the frame
+    int edges = 0;
+};
+
+// 3x5 bitmap digits (and '-') for node labels, top row in the high bits
+inline uint16_t glyphBits(char c) {
+    static const uint16_t digits[10] = {0x7B6F, 0x2C97, 0x73E7, 0x73CF, 0x5BC9, 0x79CF, 0x79EF, 0x7249, 0x7BEF, 0x7BCF};
+    if (c >= '0' && c <= '9') return digits[c - '0'];
+    if (c == '-') return 0x01C0;
+    return 0;
+}
+
+// In-memory RGB image
+class Framebuffer {
+public:
+    static const int glyphScale = 2;  // Digits are drawn 6x10 pixels
+
+    Framebuffer(int width, int height) : w(width), h(height), pixels((size_t)width * height, 0) { clearClip(); }
+
+    int width() const { return w; }
+    int height() const { return h; }
+    uint32_t pixel(int x, int y) const { return pixels[(size_t)y * w + x]; }
+
+    void clear(uint32_t color) { std::fill(pixels.begin(), pixels.end(), color); }
+
+    // Restrict drawing to the inclusive rectangle (x0, y0)-(x1, y1)
+    void setClip(int x0, int y0, int x1, int y1) {
+        clipX0 = std::max(x0, 0), clipY0 = std::max(y0, 0);
+        clipX1 = std::min(x1, w - 1), clipY1 = std::min(y1, h - 1);
+    }
+
+    void clearClip() { setClip(0, 0, w - 1, h - 1); }
+
+    void fillRect(int x, int y, int width, int height, uint32_t color) {
+        for (int row = std::max(y, clipY0); row < std::min(y + height, clipY1 + 1); row++) span(row, x, x + width - 1, color);
+    }
+
+    // One horizontal span per row of the disc
+    void fillCircle(int cx, int cy, int r, uint32_t color) {
+        for (int dy = std::max(-r, clipY0 - cy); dy <= r && cy + dy <= clipY1; dy++) {
+            int half = (int)std::sqrt((double)(r * r - dy * dy));
+            span(cy + dy, cx - half, cx + half, color);
+        }
+    }
+
+    // Midpoint circle outline
+    void circle(int cx, int cy, int r, uint32_t color) {
+        if (cx + r < clipX0 || cx - r > clipX1 || cy + r < clipY0 || cy - r > clipY1) return;
+        int x = r, y = 0, err = 1 - r;
+        while (x >= y) {
+            plot(cx + x, cy + y, color), plot(cx - x, cy + y, color), plot(cx + x, cy - y, color);
+            plot(cx - x, cy - y, color), plot(cx + y, cy + x, color), plot(cx - y, cy + x, color);
+            plot(cx + y, cy - x, color), plot(cx - y, cy - x, color);
+            y++;
+            if (err < 0) {
+                err += 2 * y + 1;
+            } else {
+                x--;
+                err += 2 * (y - x) + 1;
+            }
+        }
+    }
+
+    // Bresenham over the part of the segment inside the frame (Liang-Barsky clip), so
+    // an edge to a node far off screen costs no more than one that fits. The path
+    // does not depend on the clip rectangle, so a clipped redraw matches a full one.
+    void line(int x0, int y0, int x1, int y1, uint32_t color) {
+        double t0 = 0, t1 = 1, dx = x1 - x0, dy = y1 - y0;
+        const double p[4] = {-dx, dx, -dy, dy};
+        const double q[4] = {(double)x0, (double)(w - 1 - x0), (double)y0, (double)(h - 1 - y0)};
+        for (int i = 0; i < 4; i++) {
+            if (p[i] == 0) {
+                if (q[i] < 0) return;
+            } else if (p[i] < 0) {
+                t0 = std::max(t0, q[i] / p[i]);
+            } else {
+                t1 = std::min(t1, q[i] / p[i]);
+            }
+        }
+        if (t0 > t1) return;
+        int ax = (int)std::lround(x0 + t0 * dx), ay = (int)std::lround(y0 + t0 * dy);
+        int bx = (int)std::lround(x0 + t1 * dx), by = (int)std::lround(y0 + t1 * dy);
+        int sx = ax < bx ? 1 : -1, sy = ay < by ? 1 : -1;
+        int ex = std::abs(bx - ax), ey = -std::abs(by - ay), err = ex + ey;
+        while (true) {
+            plot(ax, ay, color);
+            if (ax == bx && ay == by) break;
+            int e2 = 2 * err;
+            if (e2 >= ey) err += ey, ax += sx;
+            if (e2 <= ex) err += ex, ay += sy;
+        }
+    }
+
+    // Text with its top-left corner at (x, y); only digits and '-' have glyphs
+    void text(int x, int y, const char* str, uint32_t color) {
+        for (; *str; str++, x += 4 * glyphScale) {
+            uint16_t bits = glyphBits(*str);
+            for (int i = 0; i < 15; i++)
+                if (bits & (0x4000 >> i)) fillRect(x + i % 3 * glyphScale, y + i / 3 * glyphScale, glyphScale, glyphScale, color);
+        }
+    }
+
+    // Full advance per character, gap included (as BGI's textwidth), so a DisplayList
+    // with 4 * glyphScale x 5 * glyphScale metrics places labels exactly as drawn here
+    int textWidth(const char* str) const { return (int)std::char_traits<char>::length(str) * 4 * glyphScale; }
+    int textHeight() const { return 5 * glyphScale; }
+
+    // Binary PPM (P6)
+    bool writePPM(const std::string& path) const {
+        FILE* file = std::fopen(path.c_str(), "wb");
+        if (!file) return false;
+        std::vector<unsigned char> rgb(pixels.size() * 3);
+        for (size_t i = 0; i < pixels.size(); i++) {
+            rgb[3 * i] = (unsigned char)(pixels[i] >> 16);
+            rgb[3 * i + 1] = (unsigned char)(pixels[i] >> 8);
+            rgb[3 * i + 2] = (unsigned char)pixels[i];
+        }
+        bool ok = std::fprintf(file, "P6\n%d %d\n255\n", w, h) > 0 && std::fwrite(rgb.data(), 1, rgb.size(), file) == rgb.size();
+        ok = (std::fclose(file) == 0) && ok;
+        return ok;
+    }
+
+private:
+    void plot(int x, int y, uint32_t color) {
+        if (x >= clipX0 && x <= clipX1 && y >= clipY0 && y <= clipY1) pixels[(size_t)y * w + x] = color;
+    }
+
+    void span(int y, int x0, int x1, uint32_t color) {
+        if (y < clipY0 || y > clipY1) return;
+        x0 = std::max(x0, clipX0);
+        x1 = std::min(x1, clipX1);
+        if (x0 <= x1) std::fill(pixels.begin() + (size_t)y * w + x0, pixels.begin() + (size_t)y * w + x1 + 1, color);
+    }
+
+    int w, h;
+    int clipX0, clipY0, clipX1, clipY1;
+    std::vector<uint32_t> pixels;
+};
+
+// Streams SVG elements to a file as they are drawn; finish() closes the document
+class SvgCanvas {
+public:
+    SvgCanvas(FILE* out, int width, int height) : out(out), w(width), h(height) {
+        std::fprintf(out, "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"%d\" height=\"%d\" font-family=\"monospace\" "
+                          "font-size=\"10\">\n", w, h);
+    }
+
+    int width() const { return w; }
+    int height() const { return h; }
+
+    void clear(uint32_t color) { std::fprintf(out, "<rect width=\"100%%\" height=\"100%%\" fill=\"#%06x\"/>\n", color); }
+
+    void fillRect(int x, int y, int width, int height, uint32_t color) {
+        std::fprintf(out, "<rect x=\"%d\" y=\"%d\" width=\"%d\" height=\"%d\" fill=\"#%06x\"/>\n", x, y, width, height, color);
+    }
+
+    void fillCircle(int cx, int cy, int r, uint32_t color) {
+        std::fprintf(out, "<circle cx=\"%d\" cy=\"%d\" r=\"%d\" fill=\"#%06x\"/>\n", cx, cy, r, color);
+    }
+
+    void circle(int cx, int cy, int r, uint32_t color) {
+        std::fprintf(out, "<circle cx=\"%d\" cy=\"%d\" r=\"%d\" fill=\"none\" stroke=\"#%06x\"/>\n", cx, cy, r, color);
+    }
+
+    void line(int x0, int y0, int x1, int y1, uint32_t color) {
+        std::fprintf(out, "<line x1=\"%d\" y1=\"%d\" x2=\"%d\" y2=\"%d\" stroke=\"#%06x\"/>\n", x0, y0, x1, y1, color);
+    }
+
+    void text(int x, int y, const char* str, uint32_t color) {
+        std::fprintf(out, "<text x=\"%d\" y=\"%d\" fill=\"#%06x\">%s</text>\n", x, y + textHeight(), color, str);
+    }
+
+    int textWidth(const char* str) const { return (int)std::char_traits<char>::length(str) * 6; }
+    int textHeight() const { return 8; }
+
+    void finish() { std::fprintf(out, "</svg>\n"); }
+
+private:
+    FILE* out;
+    int w, h;
+};
+
+template <typename N, typename Canvas>
+void renderSubtree(N* node, int first, int depth, const Viewport& view, Canvas& canvas, const RenderStyle& style,
+                   RenderStats& stats) {
+    int size = getSize(node), r = style.radius;
+    int y = view.y(depth), left = view.x(first), right = view.x(first + size - 1);
+    if (y - r >= canvas.height() || right + r < 0 || left - r >= canvas.width()) {
+        stats.culled += size;  // Children are further down and within the same columns
+        return;
+    }
+
+    char label[12];
+    if (size > 1 && view.columnWidth < r && right - left < style.lodPixels) {
+        int boxLeft = std::min(left, right - 1);  // At least two pixels wide
+        canvas.fillRect(boxLeft, y - r / 2, right - boxLeft + 1, r, style.aggregate);
+        std::snprintf(label, sizeof label, "%d", size);
+        if (canvas.textWidth(label) <= right - boxLeft + 1)
+            canvas.text((left + right - canvas.textWidth(label)) / 2, y - canvas.textHeight() / 2, label, style.text);
+        stats.aggregates++;
+        stats.collapsed += size;
+        return;
+    }
+
+    // Edges first; each child's node (or glyph) is drawn over its end
+    int column = first + getSize(node->left);
+    int x = view.x(column);
+    if (node->left) {
+        canvas.line(x, y, view.x(column - 1 - getSize(node->left->right)), view.y(depth + 1), style.edge);
+        stats.edges++;
+        renderSubtree(node->left, first, depth + 1, view, canvas, style, stats);
+    }
+    if (node->right) {
+        canvas.line(x, y, view.x(column + 1 + getSize(node->right->left)), view.y(depth + 1), style.edge);
+        stats.edges++;
+        renderSubtree(node->right, column + 1, depth + 1, view, canvas, style, stats);
+    }
+
+    canvas.fillCircle(x, y, r, style.nodeFill);
+    canvas.circle(x, y, r, style.nodeBorder);
+    std::snprintf(label, sizeof label, "%d", (int)node->data);
+    if (canvas.textWidth(label) <= 2 * r)
+        canvas.text(x - canvas.textWidth(label) / 2, y - canvas.textHeight() / 2, label, style.text);
+    stats.nodes++;
+}
+
+// Draw the tree rooted at root onto canvas through view. Recursion stops at the
+// bottom of the frame (or at a collapsed subtree), so its depth is bounded by the
+// number of rows that fit, not by the height of the tree.
+template <typename N, typename Canvas>
+RenderStats renderTree(N* root, const Viewport& view, Canvas& canvas, const RenderStyle& style = RenderStyle()) {
+    static_assert(N::augment_type::tracksSize, "node columns come from cached subtree sizes");
+    RenderStats stats;
+    canvas.clear(style.background);
+    if (root) renderSubtree(root, 0, 0, view, canvas, style, stats);
+    return stats;
+}
+
+// Render the whole tree fitted into a width x height image and write it to path:
+// SVG if the name ends in .svg, PPM otherwise
+template <typename N>
+bool renderToFile(N* root, const std::string& path, int width = 800, int height = 600,
+                  const RenderStyle& style = RenderStyle(), RenderStats* stats = nullptr) {
+    int margin = style.radius + 20;
+    Viewport view = Viewport::fit(root, width / 2, margin, width - 2 * margin, 3 * style.radius, 0.0, 150.0);
+    RenderStats drawn;
+    bool ok;
+    if (path.size() >= 4 && path.compare(path.size() - 4, 4, ".svg") == 0) {
+        FILE* file = std::fopen(path.c_str(), "w");
+        if (!file) return false;
+        SvgCanvas canvas(file, width, height);
+        drawn = renderTree(root, view, canvas, style);
+        canvas.finish();
+        ok = std::fclose(file) == 0;
+    } else {
+        Framebuffer canvas(width, height);
+        drawn = renderTree(root, view, canvas, style);
+        ok = canvas.writePPM(path);
+    }
+    if (stats) *stats = drawn;
+    return ok;
+}
+
+}  // namespace core
+
+#endif
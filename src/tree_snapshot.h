@@ -0,0 +1,320 @@
+#ifndef TREE_SNAPSHOT_H
+#define TREE_SNAPSHOT_H
+
+// Binary snapshot files for the BST and AVL trees.
+// Layout: a 48-byte SnapshotHeader followed by one 16-byte SnapshotRecord per node
+// in preorder. Each record stores the key, the subtree height and size, and the size
+// of its left subtree, so a node's left child is the next record and its right child
+// starts leftSize records later. That is enough to search, rank and walk the tree in
+// place: SnapshotView maps the file read-only and answers queries without allocating
+// a node. Values are stored in native byte order; the checksum is FNV-1a over the
+// records taken as 64-bit words.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "node_pool.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+enum SnapshotKind : uint32_t { SNAPSHOT_BST = 1, SNAPSHOT_AVL = 2 };
+
+const uint32_t SNAPSHOT_VERSION = 1;
+
+struct SnapshotHeader {
+    char magic[8];  // "TREESNAP"
+    uint32_t version;
+    uint32_t kind;
+    uint64_t count;
+    uint32_t recordSize;
+    uint32_t reserved;
+    uint64_t checksum;
+    uint64_t reserved2;
+};
+
+struct SnapshotRecord {
+    int32_t data;
+    int32_t height;
+    int32_t size;
+    int32_t leftSize;
+};
+
+static_assert(sizeof(SnapshotHeader) == 48, "snapshot header layout");
+static_assert(sizeof(SnapshotRecord) == 16, "snapshot record layout");
+
+inline uint64_t snapshotChecksum(const SnapshotRecord* records, uint64_t count) {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(records);
+    uint64_t hash = 14695981039346656037ull;
+    for (uint64_t i = 0; i < count * sizeof(SnapshotRecord); i += 8) {
+        uint64_t word;
+        std::memcpy(&word, bytes + i, 8);
+        hash = (hash ^ word) * 1099511628211ull;
+    }
+    return hash;
+}
+
+// Write the tree rooted at root to path. Heights and sizes are recomputed from the
+// structure, so any node type with data/left/right works. Returns false on I/O errors.
+template <typename Node>
+inline bool saveSnapshot(const std::string& path, Node* root, SnapshotKind kind) {
+    std::vector<Node*> order;
+    std::vector<Node*> stack;
+    if (root) stack.push_back(root);
+    while (!stack.empty()) {
+        Node* node = stack.back();
+        stack.pop_back();
+        order.push_back(node);
+        if (node->right) stack.push_back(node->right);
+        if (node->left) stack.push_back(node->left);
+    }
+
+    // In reverse preorder both subtrees of a node are finished before it, with the
+    // left subtree's record on top of the stack
+    std::vector<SnapshotRecord> records(order.size());
+    std::vector<SnapshotRecord> finished;
+    for (size_t i = order.size(); i-- > 0;) {
+        Node* node = order[i];
+        SnapshotRecord left{0, 0, 0, 0}, right{0, 0, 0, 0};
+        if (node->left) { left = finished.back(); finished.pop_back(); }
+        if (node->right) { right = finished.back(); finished.pop_back(); }
+        SnapshotRecord& record = records[i];
+        record.data = node->data;
+        record.height = 1 + (left.height > right.height ? left.height : right.height);
+        record.size = 1 + left.size + right.size;
+        record.leftSize = left.size;
+        finished.push_back(record);
+    }
+
+    SnapshotHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, "TREESNAP", 8);
+    header.version = SNAPSHOT_VERSION;
+    header.kind = kind;
+    header.count = records.size();
+    header.recordSize = sizeof(SnapshotRecord);
+    header.checksum = snapshotChecksum(records.data(), records.size());  // Reads nothing when empty
+
+    // An empty tree is just the header (records.data() may be null then)
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) return false;
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+              (records.empty() ||
+               std::fwrite(records.data(), sizeof(SnapshotRecord), records.size(), file) == records.size());
+    ok = (std::fclose(file) == 0) && ok;
+    return ok;
+}
+
+// Read-only view of a snapshot file, mapped with mmap where available (read into
+// memory otherwise). Queries run directly on the records.
+class SnapshotView {
+public:
+    SnapshotView() = default;
+    SnapshotView(const SnapshotView&) = delete;
+    SnapshotView& operator=(const SnapshotView&) = delete;
+    ~SnapshotView() { close(); }
+
+    // Map path and check the header. With verify, also check the checksum and that the
+    // records form a valid tree of that kind (sizes, key order, heights; two passes).
+    bool open(const std::string& path, SnapshotKind kind, bool verify = true) {
+        close();
+        if (!mapFile(path)) return fail("cannot read " + path);
+        if (length < sizeof(SnapshotHeader)) return fail("file too short");
+        const SnapshotHeader* header = reinterpret_cast<const SnapshotHeader*>(base);
+        if (std::memcmp(header->magic, "TREESNAP", 8) != 0) return fail("not a tree snapshot");
+        if (header->version != SNAPSHOT_VERSION) return fail("unsupported snapshot version");
+        if (header->kind != kind) return fail(kind == SNAPSHOT_AVL ? "not an AVL snapshot" : "not a BST snapshot");
+        if (header->recordSize != sizeof(SnapshotRecord) ||
+            header->count != (length - sizeof(SnapshotHeader)) / sizeof(SnapshotRecord) ||
+            length != sizeof(SnapshotHeader) + header->count * sizeof(SnapshotRecord))
+            return fail("truncated or malformed snapshot");
+
+        records = reinterpret_cast<const SnapshotRecord*>(base + sizeof(SnapshotHeader));
+        count = header->count;
+        if (verify) {
+            if (snapshotChecksum(records, count) != header->checksum) return fail("checksum mismatch");
+            if (!validShape(kind)) return fail("inconsistent tree shape, key order or heights");
+        }
+        return true;
+    }
+
+    const std::string& error() const { return lastError; }
+
+    uint64_t size() const { return count; }
+    int height() const { return count ? records[0].height : 0; }
+    const SnapshotRecord* data() const { return records; }
+
+    bool searchNode(int key) const {
+        uint64_t i = 0;
+        while (i < count) {
+            const SnapshotRecord& node = records[i];
+            if (key == node.data) return true;
+            if (key < node.data) {
+                if (node.leftSize == 0) return false;
+                i = i + 1;
+            } else {
+                if (node.size - 1 - node.leftSize == 0) return false;
+                i = i + 1 + node.leftSize;
+            }
+        }
+        return false;
+    }
+
+    // Number of keys less than key
+    uint64_t order_of_key(int key) const {
+        uint64_t i = 0, rank = 0;
+        while (i < count) {
+            const SnapshotRecord& node = records[i];
+            if (key <= node.data) {
+                if (node.leftSize == 0) break;
+                i = i + 1;
+            } else {
+                rank += node.leftSize + 1;
+                if (node.size - 1 - node.leftSize == 0) break;
+                i = i + 1 + node.leftSize;
+            }
+        }
+        return rank;
+    }
+
+    // Visit the keys in sorted order
+    template <typename F>
+    void forEach(F visit) const {
+        std::vector<uint64_t> stack;
+        uint64_t i = 0;
+        bool descend = count > 0;
+        while (descend || !stack.empty()) {
+            while (descend) {
+                stack.push_back(i);
+                descend = records[i].leftSize > 0;
+                i = i + 1;
+            }
+            i = stack.back();
+            stack.pop_back();
+            visit(records[i].data);
+            descend = records[i].size - 1 - records[i].leftSize > 0;
+            i = i + 1 + records[i].leftSize;
+        }
+    }
+
+    void close() {
+#if defined(__unix__) || defined(__APPLE__)
+        if (mapped) munmap(const_cast<char*>(base), length);
+#endif
+        mapped = false;
+        buffer.clear();
+        base = nullptr;
+        length = 0;
+        records = nullptr;
+        count = 0;
+    }
+
+private:
+    bool fail(const std::string& message) {
+        close();
+        lastError = message;
+        return false;
+    }
+
+    bool mapFile(const std::string& path) {
+#if defined(__unix__) || defined(__APPLE__)
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+            void* view = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (view != MAP_FAILED) {
+                ::close(fd);
+                base = static_cast<const char*>(view);
+                length = (size_t)st.st_size;
+                mapped = true;
+                return true;
+            }
+        }
+        ::close(fd);
+#endif
+        FILE* file = std::fopen(path.c_str(), "rb");
+        if (!file) return false;
+        char chunk[1 << 16];
+        size_t got;
+        while ((got = std::fread(chunk, 1, sizeof(chunk), file)) > 0) buffer.insert(buffer.end(), chunk, chunk + got);
+        std::fclose(file);
+        base = buffer.data();
+        length = buffer.size();
+        return true;
+    }
+
+    // The records must describe exactly one tree: each record's size is the one its
+    // parent's leftSize (or size - 1 - leftSize) announced, the root spans the file,
+    // keys respect the search order (BST: left < key <= right, as duplicates go right;
+    // AVL: strictly increasing) and every height is 1 + the taller child's, with
+    // children at most one level apart in an AVL snapshot
+    bool validShape(SnapshotKind kind) const {
+        if (count == 0) return true;
+        struct Slot {
+            int64_t size, lo, hi;  // Expected subtree size and inclusive key bounds
+        };
+        std::vector<Slot> slots{{(int64_t)count, INT32_MIN, INT32_MAX}};  // Next subtree on top
+        for (uint64_t i = 0; i < count; i++) {
+            if (slots.empty()) return false;
+            Slot slot = slots.back();
+            slots.pop_back();
+            const SnapshotRecord& node = records[i];
+            int64_t rightSize = (int64_t)node.size - 1 - node.leftSize;
+            if (node.size != slot.size || node.leftSize < 0 || rightSize < 0) return false;
+            if (node.data < slot.lo || node.data > slot.hi) return false;
+            if (rightSize > 0) slots.push_back({rightSize, (int64_t)node.data + (kind == SNAPSHOT_AVL), slot.hi});
+            if (node.leftSize > 0) slots.push_back({node.leftSize, slot.lo, (int64_t)node.data - 1});
+        }
+        if (!slots.empty()) return false;
+
+        // Children follow their parent, so a backwards pass sees their heights checked
+        for (uint64_t i = count; i-- > 0;) {
+            const SnapshotRecord& node = records[i];
+            int left = node.leftSize > 0 ? records[i + 1].height : 0;
+            int right = node.size - 1 - node.leftSize > 0 ? records[i + 1 + node.leftSize].height : 0;
+            if (node.height != 1 + std::max(left, right)) return false;
+            if (kind == SNAPSHOT_AVL && std::abs(left - right) > 1) return false;
+        }
+        return true;
+    }
+
+    const char* base = nullptr;
+    size_t length = 0;
+    bool mapped = false;
+    std::vector<char> buffer;
+    const SnapshotRecord* records = nullptr;
+    uint64_t count = 0;
+    std::string lastError;
+};
+
+// Rebuild a pointer tree from a view (one node per record, no rebalancing).
+// init copies the cached fields of a record into a node.
+template <typename Node, typename Init>
+inline Node* buildFromSnapshot(const SnapshotView& view, NodePool<Node>* pool, Init init) {
+    Node* root = nullptr;
+    std::vector<Node**> slots{&root};  // Child links still to be filled, next one on top
+    const SnapshotRecord* records = view.data();
+    for (uint64_t i = 0; i < view.size() && !slots.empty(); i++) {
+        const SnapshotRecord& record = records[i];
+        Node* node = newNode(pool, record.data);
+        init(node, record);
+        Node** slot = slots.back();
+        slots.pop_back();
+        *slot = node;
+        if (record.size - 1 - record.leftSize > 0) slots.push_back(&node->right);
+        if (record.leftSize > 0) slots.push_back(&node->left);
+    }
+    return root;
+}
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef TREE_STATS_H
+#define TREE_STATS_H
+
+#include <algorithm>
+#include <cstdlib>
+#include <ostream>
+#include <vector>
+
+// Structural statistics of a binary tree, gathered in one pass
+struct TreeStats {
+    int height = 0;
+    int size = 0;
+    int leaves = 0;
+    int diameter = 0;       // Nodes on the longest path, as findDiameter counts it
+    bool balanced = true;   // Subtree heights differ by at most one at every node
+    std::vector<int> depthCounts;  // depthCounts[d] = number of nodes at depth d (root = 0)
+};
+
+// Single post-order pass computing everything in TreeStats in O(n).
+// Works for any node type with left/right pointers (t_node, AVLNode). The walk uses
+// explicit stacks, so degenerate trees do not overflow the native stack.
+template <typename Node>
+inline TreeStats computeStats(Node* root) {
+    TreeStats stats;
+    std::vector<Node*> stack;
+    std::vector<int> heights;  // Heights of finished subtrees, waiting for their parent
+    Node* current = root;
+    Node* lastVisited = nullptr;
+    while (current || !stack.empty()) {
+        while (current) {
+            stack.push_back(current);
+            size_t depth = stack.size() - 1;
+            if (stats.depthCounts.size() <= depth) stats.depthCounts.push_back(0);
+            stats.depthCounts[depth]++;
+            current = current->left;
+        }
+        Node* top = stack.back();
+        if (top->right && top->right != lastVisited) {
+            current = top->right;
+            continue;
+        }
+
+        int rightHeight = 0, leftHeight = 0;
+        if (top->right) { rightHeight = heights.back(); heights.pop_back(); }
+        if (top->left) { leftHeight = heights.back(); heights.pop_back(); }
+
+        stats.size++;
+        if (!top->left && !top->right) stats.leaves++;
+        if (std::abs(leftHeight - rightHeight) > 1) stats.balanced = false;
+        stats.diameter = std::max(stats.diameter, leftHeight + rightHeight + 1);
+        heights.push_back(std::max(leftHeight, rightHeight) + 1);
+
+        lastVisited = top;
+        stack.pop_back();
+    }
+    stats.height = heights.empty() ? 0 : heights.back();
+    return stats;
+}
+
+// Machine-readable form: a single JSON object on one line
+inline void printStatsJson(std::ostream& out, const TreeStats& stats) {
+    out << "{\"height\":" << stats.height << ",\"size\":" << stats.size << ",\"leaves\":" << stats.leaves
+        << ",\"diameter\":" << stats.diameter << ",\"balanced\":" << (stats.balanced ? "true" : "false")
+        << ",\"depth_histogram\":[";
+    for (size_t d = 0; d < stats.depthCounts.size(); d++) out << (d ? "," : "") << stats.depthCounts[d];
+    out << "]}\n";
+}
+
+#endif
@@ -0,0 +1,105 @@
+// Random mutation sequences against the AVL tree, with avl::checkInvariants (cached
+// heights and sizes, key order, balance) and the key set compared with a std::set
+// after every step, along with order_of_key, count_not_greater and find_by_order.
+// Steps: insert, erase, small and large mergeBatch, bulkLoad replacing the tree,
+// and a saveAVL/loadAVL round trip.
+//
+//   avl_invariants_test [steps] [seed]
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "test_util.h"
+#include "../src/avl_tree.h"
+#include "../src/node_pool.h"
+
+using namespace std;
+
+static vector<int> keysOf(avl::AVLNode* root) {
+    vector<int> keys;
+    core::forEachInorder(root, [&](avl::AVLNode* node) { keys.push_back(node->data); });
+    return keys;
+}
+
+static vector<int> randomBatch(mt19937& rng, size_t maxSize, int keyRange) {
+    vector<int> batch(1 + rng() % maxSize);
+    for (int& k : batch) k = (int)(rng() % keyRange);
+    sort(batch.begin(), batch.end());
+    return batch;
+}
+
+int main(int argc, char** argv) {
+    int steps = argc > 1 ? stoi(argv[1]) : 20000;
+    unsigned seed = argc > 2 ? (unsigned)stoul(argv[2]) : 42;
+    const int keyRange = 3000;  // Small enough that inserts meet duplicates and erases find keys
+    string snapshotPath = "avl_invariants_test.snap";
+
+    mt19937 rng(seed);
+    NodePool<avl::AVLNode> pool;
+    avl::AVLNode* root = nullptr;
+    set<int> model;
+
+    for (int step = 0; step < steps; step++) {
+        int op = (int)(rng() % 100);
+        string what;
+        if (op < 45) {
+            int key = (int)(rng() % keyRange);
+            root = avl::insert(root, key, &pool);
+            model.insert(key);
+            what = "insert " + to_string(key);
+        } else if (op < 85) {
+            int key = (int)(rng() % keyRange);
+            root = avl::erase(root, key, &pool);
+            model.erase(key);
+            what = "erase " + to_string(key);
+        } else if (op < 91) {
+            vector<int> batch = randomBatch(rng, 8, keyRange);  // Inserted one by one
+            root = avl::mergeBatch(root, batch, &pool);
+            model.insert(batch.begin(), batch.end());
+            what = "mergeBatch of " + to_string(batch.size());
+        } else if (op < 94) {
+            vector<int> batch = randomBatch(rng, 2000, keyRange);  // Flattened and rebuilt
+            root = avl::mergeBatch(root, batch, &pool);
+            model.insert(batch.begin(), batch.end());
+            what = "mergeBatch of " + to_string(batch.size());
+        } else if (op < 97) {
+            vector<int> keys = randomBatch(rng, 1000, keyRange);
+            shuffle(keys.begin(), keys.end(), rng);
+            vector<int> old;
+            avl::flattenAndRelease(root, old, &pool);
+            root = avl::bulkLoad(keys, &pool);
+            model = set<int>(keys.begin(), keys.end());
+            what = "bulkLoad of " + to_string(keys.size());
+        } else {
+            what = "save/load";
+            CHECK(avl::saveAVL(snapshotPath, root));
+            SnapshotView view;
+            CHECK_AT(view.open(snapshotPath, SNAPSHOT_AVL), view.error().c_str());
+            vector<int> old;
+            avl::flattenAndRelease(root, old, &pool);
+            root = avl::loadAVL(view, &pool);
+        }
+
+        string context = "step " + to_string(step) + " (" + what + ")";
+        CHECK_AT(avl::checkInvariants(root), context.c_str());
+        vector<int> expected(model.begin(), model.end());
+        CHECK_AT(keysOf(root) == expected, context.c_str());
+
+        // Order statistics from the cached sizes against the model
+        int probe = (int)(rng() % (keyRange + 2)) - 1;
+        int less = (int)(lower_bound(expected.begin(), expected.end(), probe) - expected.begin());
+        int notGreater = (int)(upper_bound(expected.begin(), expected.end(), probe) - expected.begin());
+        CHECK_AT(avl::order_of_key(root, probe) == less, context.c_str());
+        CHECK_AT(avl::count_not_greater(root, probe) == notGreater, context.c_str());
+        int k = (int)(rng() % (expected.size() + 2)) - 1;
+        avl::AVLNode* kth = avl::find_by_order(root, k);
+        CHECK_AT(k >= 0 && k < (int)expected.size() ? kth && kth->data == expected[k] : !kth, context.c_str());
+        if (test::failures()) break;  // Later steps would only repeat the first failure
+    }
+    remove(snapshotPath.c_str());
+    return test::testResult("avl_invariants_test");
+}
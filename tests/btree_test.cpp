@@ -0,0 +1,79 @@
+// Random inserts into the B-tree against a sorted std::vector.
+// Keys come from the whole int range, from ascending and descending runs (which
+// split the rightmost and leftmost nodes over and over), as repeats of keys already
+// present, and as the boundary keys INT_MIN, INT_MAX and their neighbours; INT_MAX is
+// also the nodes' padding value. After every step insert's result, size, searchNode
+// and order_of_key are checked against the model, and the key order and the height
+// bound every few hundred steps.
+//
+//   btree_test [steps] [seed]
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "test_util.h"
+#include "../src/btree.h"
+
+using namespace std;
+
+static vector<int> keysOf(const btree::BTree& tree) {
+    vector<int> keys;
+    tree.forEach([&](int key) { keys.push_back(key); });
+    return keys;
+}
+
+int main(int argc, char** argv) {
+    int steps = argc > 1 ? stoi(argv[1]) : 50000;
+    unsigned seed = argc > 2 ? (unsigned)stoul(argv[2]) : 42;
+    const int boundary[] = {INT_MIN, INT_MIN + 1, INT_MIN + 2, INT_MAX, INT_MAX - 1, INT_MAX - 2, -1, 0, 1};
+
+    mt19937 rng(seed);
+    btree::BTree tree;
+    vector<int> model;  // Sorted
+    vector<int> inserted;
+    int ascending = 0, descending = 0;
+
+    // The empty tree
+    CHECK(tree.size() == 0 && tree.height() == 0);
+    CHECK(!tree.searchNode(0) && !tree.searchNode(INT_MAX) && !tree.searchNode(INT_MIN));
+    CHECK(tree.order_of_key(INT_MAX) == 0 && tree.order_of_key(INT_MIN) == 0);
+
+    for (int step = 0; step < steps; step++) {
+        int op = (int)(rng() % 100), key;
+        if (op < 40) key = (int)rng();
+        else if (op < 60) key = 1000000 + ascending++;
+        else if (op < 80) key = -1000000 - descending++;
+        else if (op < 90 && !inserted.empty()) key = inserted[rng() % inserted.size()];
+        else key = boundary[rng() % 9];
+
+        string context = "step " + to_string(step) + " (insert " + to_string(key) + ")";
+        auto at = lower_bound(model.begin(), model.end(), key);
+        bool added = at == model.end() || *at != key;
+        if (added) model.insert(at, key);
+        CHECK_AT(tree.insert(key) == added, context.c_str());
+        if (added) inserted.push_back(key);
+        CHECK_AT(tree.size() == (int)model.size(), context.c_str());
+
+        int below = key == INT_MIN ? key : key - 1, above = key == INT_MAX ? key : key + 1;
+        int probes[] = {key, below, above, INT_MIN, INT_MAX, (int)rng(), inserted[rng() % inserted.size()]};
+        for (int probe : probes) {
+            int less = (int)(lower_bound(model.begin(), model.end(), probe) - model.begin());
+            bool present = less < (int)model.size() && model[less] == probe;
+            CHECK_AT(tree.searchNode(probe) == present, context.c_str());
+            CHECK_AT(tree.order_of_key(probe) == less, context.c_str());
+        }
+
+        if (step % 500 == 0 || step == steps - 1) {
+            CHECK_AT(keysOf(tree) == model, context.c_str());
+            // Every node but the root holds at least MAX_KEYS / 2 keys
+            double bound = 1 + log((model.size() + 1) / 2.0) / log(btree::MAX_KEYS / 2 + 1.0);
+            CHECK_AT(tree.height() <= max(1.0, floor(bound + 1e-9)), context.c_str());
+        }
+        if (test::failures()) break;
+    }
+    return test::testResult("btree_test");
+}
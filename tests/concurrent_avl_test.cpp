@@ -0,0 +1,128 @@
+// ConcurrentAVLTree against a std::set and the pointer AVL tree, then under threads.
+// Single-threaded, random inserts (duplicates, runs, INT_MIN / INT_MAX) must leave the
+// keys of the set, the height of avl::insert's tree and nothing waiting for
+// reclamation, since no reader is active. Then one writer inserts a shuffled key
+// range while readers check that every version they see is sorted, never smaller
+// than the last one and never loses a key; and several writers insert disjoint keys
+// at once. Either way the final tree must hold every key.
+//
+//   concurrent_avl_test [steps] [seed]
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cmath>
+#include <random>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "test_util.h"
+#include "../src/avl_tree.h"
+#include "../src/concurrent_avl_tree.h"
+#include "../src/node_pool.h"
+
+using namespace std;
+
+static vector<int> keysOf(const avl::ConcurrentAVLTree& tree) {
+    vector<int> keys;
+    tree.forEach([&](int key) { keys.push_back(key); });
+    return keys;
+}
+
+// Readers run until the writer is done; each version must be sorted and contain the previous one
+static void readConcurrently(avl::ConcurrentAVLTree& tree, const vector<int>& keys, int readers) {
+    atomic<bool> done{false};
+    atomic<int> errors{0};
+    vector<thread> threads;
+    for (int r = 0; r < readers; r++) {
+        threads.emplace_back([&, r] {
+            mt19937 rng(r);
+            int lastSize = 0;
+            vector<char> seen(keys.size(), 0);
+            while (!done.load()) {
+                vector<int> version = keysOf(tree);
+                if (!is_sorted(version.begin(), version.end()) || adjacent_find(version.begin(), version.end()) != version.end() ||
+                    (int)version.size() < lastSize)
+                    errors++;
+                lastSize = (int)version.size();
+                for (int i = 0; i < 200; i++) {
+                    size_t k = rng() % keys.size();
+                    bool present = tree.searchNode(keys[k]);
+                    if (seen[k] && !present) errors++;  // Keys are never removed
+                    seen[k] |= present;
+                }
+                if (tree.size() < lastSize) errors++;
+            }
+        });
+    }
+    for (int key : keys) tree.insert(key);
+    done = true;
+    for (thread& t : threads) t.join();
+    CHECK(errors.load() == 0);
+}
+
+int main(int argc, char** argv) {
+    int steps = argc > 1 ? stoi(argv[1]) : 20000;
+    unsigned seed = argc > 2 ? (unsigned)stoul(argv[2]) : 42;
+    mt19937 rng(seed);
+
+    {
+        avl::ConcurrentAVLTree tree;
+        NodePool<avl::AVLNode> pool;
+        avl::AVLNode* root = nullptr;
+        set<int> model;
+        int run = 0;
+        for (int step = 0; step < steps; step++) {
+            int op = (int)(rng() % 100), key;
+            if (op < 60) key = (int)(rng() % 5000);
+            else if (op < 80) key = 10000 + run++;
+            else if (op < 95) key = -10000 - run++;
+            else key = rng() % 2 ? INT_MIN : INT_MAX;
+
+            string context = "step " + to_string(step) + " (insert " + to_string(key) + ")";
+            tree.insert(key);
+            root = avl::insert(root, key, &pool);
+            model.insert(key);
+            CHECK_AT(tree.size() == (int)model.size() && tree.height() == avl::findHeight(root), context.c_str());
+            for (int probe : {key, key == INT_MIN ? key : key - 1, (int)(rng() % 5000)})
+                CHECK_AT(tree.searchNode(probe) == (model.count(probe) == 1), context.c_str());
+            if (step % 100 == 0 || step == steps - 1) {
+                CHECK_AT(keysOf(tree) == vector<int>(model.begin(), model.end()), context.c_str());
+                CHECK_AT(tree.pendingReclaim() == 0, context.c_str());
+            }
+            if (test::failures()) break;
+        }
+    }
+
+    // One writer, three readers
+    {
+        avl::ConcurrentAVLTree tree;
+        vector<int> keys(20000);
+        for (int i = 0; i < (int)keys.size(); i++) keys[i] = 3 * i - 30000;
+        shuffle(keys.begin(), keys.end(), rng);
+        readConcurrently(tree, keys, 3);
+        sort(keys.begin(), keys.end());
+        CHECK(keysOf(tree) == keys);
+        tree.insert(INT_MAX);  // Readers are gone, so this frees every retired batch
+        CHECK(tree.pendingReclaim() == 0);
+    }
+
+    // Four writers with disjoint keys
+    {
+        avl::ConcurrentAVLTree tree;
+        vector<thread> writers;
+        for (int w = 0; w < 4; w++)
+            writers.emplace_back([&tree, w] {
+                for (int i = 0; i < 5000; i++) tree.insert(4 * ((i * 7919) % 5000) + w);
+            });
+        for (thread& t : writers) t.join();
+        vector<int> keys = keysOf(tree);
+        CHECK(keys.size() == 20000 && tree.size() == 20000);
+        for (int i = 0; i < (int)keys.size(); i++) CHECK_AT(keys[i] == i, "four writers");
+        CHECK(tree.height() <= 1.4405 * log2(20002.0));
+    }
+
+    return test::testResult("concurrent_avl_test");
+}
@@ -0,0 +1,109 @@
+// BST and AVL erase against std::multiset and std::set.
+// Keys come from a small range, so the BST holds many duplicates of each key and
+// erases often remove one copy of several; INT_MIN and INT_MAX are mixed in, and
+// every few thousand steps both trees are erased down to empty in random order.
+// After every step the BST must keep the order it was built with (left keys less,
+// right keys not less), correct cached sizes, the model's keys with their counts
+// and order_of_key; the AVL tree must pass avl::checkInvariants and hold the set's
+// keys. Erasing must return each removed node to its pool.
+//
+//   erase_test [steps] [seed]
+
+#include <algorithm>
+#include <climits>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "test_util.h"
+#include "../src/avl_tree.h"
+#include "../src/binary_search_tree.h"
+#include "../src/node_pool.h"
+
+using namespace std;
+
+// Keys in (lo, hi) on the left of a node and in [node, hi) on its right; returns the subtree size
+static int checkBST(bst::t_node* node, long long lo, long long hi, bool& ok) {
+    if (!node) return 0;
+    if (node->data <= lo || node->data >= hi) ok = false;
+    int size = 1 + checkBST(node->left, lo, node->data, ok) + checkBST(node->right, (long long)node->data - 1, hi, ok);
+    if (node->size != size) ok = false;
+    return size;
+}
+
+template <typename N>
+static vector<int> keysOf(N* root) {
+    vector<int> keys;
+    core::forEachInorder(root, [&](N* node) { keys.push_back(node->data); });
+    return keys;
+}
+
+int main(int argc, char** argv) {
+    int steps = argc > 1 ? stoi(argv[1]) : 20000;
+    unsigned seed = argc > 2 ? (unsigned)stoul(argv[2]) : 42;
+    const int keyRange = 200;  // About ten copies of each key in the BST
+    mt19937 rng(seed);
+
+    NodePool<bst::t_node> bstPool;
+    NodePool<avl::AVLNode> avlPool;
+    bst::t_node* bstRoot = nullptr;
+    avl::AVLNode* avlRoot = nullptr;
+    multiset<int> bstModel;
+    set<int> avlModel;
+
+    auto randomKey = [&] {
+        int r = (int)(rng() % 100);
+        return r == 0 ? INT_MIN : r == 1 ? INT_MAX : (int)(rng() % keyRange) - keyRange / 2;
+    };
+
+    for (int step = 0; step < steps; step++) {
+        string what;
+        if (step % 5000 == 4999) {
+            vector<int> keys(bstModel.begin(), bstModel.end());
+            shuffle(keys.begin(), keys.end(), rng);
+            for (int key : keys) {
+                bstRoot = bst::eraseBST(bstRoot, key, &bstPool);
+                avlRoot = avl::erase(avlRoot, key, &avlPool);
+            }
+            bstModel.clear();
+            avlModel.clear();
+            CHECK(!bstRoot && !avlRoot);
+            what = "erase all";
+        } else if (rng() % 100 < 55) {
+            int key = randomKey();
+            bstRoot = bst::insertBST(bstRoot, key, &bstPool);
+            avlRoot = avl::insert(avlRoot, key, &avlPool);
+            bstModel.insert(key);
+            avlModel.insert(key);
+            what = "insert " + to_string(key);
+        } else {
+            int key = randomKey();
+            bstRoot = bst::eraseBST(bstRoot, key, &bstPool);
+            avlRoot = avl::erase(avlRoot, key, &avlPool);
+            auto it = bstModel.find(key);
+            if (it != bstModel.end()) bstModel.erase(it);  // One copy
+            avlModel.erase(key);
+            what = "erase " + to_string(key);
+        }
+
+        string context = "step " + to_string(step) + " (" + what + ")";
+        bool ok = true;
+        checkBST(bstRoot, (long long)INT_MIN - 1, (long long)INT_MAX + 1, ok);
+        CHECK_AT(ok, context.c_str());
+        CHECK_AT(keysOf(bstRoot) == vector<int>(bstModel.begin(), bstModel.end()), context.c_str());
+        CHECK_AT(bst::countNodes(bstRoot) == (int)bstModel.size(), context.c_str());
+        int probe = randomKey();
+        int less = (int)distance(bstModel.begin(), bstModel.lower_bound(probe));
+        CHECK_AT(bst::order_of_key(bstRoot, probe) == less, context.c_str());
+        CHECK_AT(bst::searchNode(bstRoot, probe) == (bstModel.count(probe) > 0), context.c_str());
+
+        CHECK_AT(avl::checkInvariants(avlRoot), context.c_str());
+        CHECK_AT(keysOf(avlRoot) == vector<int>(avlModel.begin(), avlModel.end()), context.c_str());
+
+        CHECK_AT(bstPool.stats().liveNodes == bstModel.size(), context.c_str());
+        CHECK_AT(avlPool.stats().liveNodes == avlModel.size(), context.c_str());
+        if (test::failures()) break;
+    }
+    return test::testResult("erase_test");
+}
@@ -0,0 +1,114 @@
+// Ordered iterators and range scans against std::multiset (BST, duplicates kept) and
+// std::set (AVL).
+// Random inserts and erases; after every step the keys from begin()..end() and from
+// end() back with -- must match the model, and lower_bound, upper_bound and
+// range(lo, hi) must match it for random bounds, bounds at INT_MIN / INT_MAX, lo > hi
+// and lo == hi. Iterators from lower_bound are also walked both ways from where
+// they start.
+//
+//   iterator_test [steps] [seed]
+
+#include <algorithm>
+#include <climits>
+#include <iterator>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "test_util.h"
+#include "../src/avl_tree.h"
+#include "../src/binary_search_tree.h"
+#include "../src/node_pool.h"
+
+using namespace std;
+
+template <typename Iterator>
+static vector<int> collect(Iterator first, Iterator last) {
+    vector<int> keys;
+    for (; first != last; ++first) keys.push_back(*first);
+    return keys;
+}
+
+template <typename Node, typename Model>
+static void checkIterators(Node* root, const Model& model, mt19937& rng, const string& context) {
+    using namespace core;
+    vector<int> expected(model.begin(), model.end());
+    CHECK_AT(collect(beginInorder(root), endInorder(root)) == expected, context.c_str());
+
+    vector<int> backward;
+    auto it = endInorder(root), first = beginInorder(root);
+    while (it != first) backward.push_back(*--it);
+    CHECK_AT(vector<int>(expected.rbegin(), expected.rend()) == backward, context.c_str());
+
+    const int keyRange = 1000;
+    auto randomKey = [&] { return (int)(rng() % (keyRange + 20)) - 10; };
+    vector<pair<int, int>> bounds = {{INT_MIN, INT_MAX}, {INT_MIN, randomKey()}, {randomKey(), INT_MAX},
+                                     {INT_MAX, INT_MIN}, {INT_MAX, INT_MAX}, {INT_MIN, INT_MIN}};
+    for (int i = 0; i < 6; i++) bounds.push_back({randomKey(), randomKey()});  // Some with lo > hi
+    int same = randomKey();
+    bounds.push_back({same, same});
+    if (!expected.empty()) bounds.push_back({expected[rng() % expected.size()], expected[rng() % expected.size()]});
+
+    for (auto [lo, hi] : bounds) {
+        auto first = model.lower_bound(lo), last = lo <= hi ? model.upper_bound(hi) : first;
+        TreeRange<Node> scan = range(root, lo, hi);
+        CHECK_AT(collect(scan.begin(), scan.end()) == vector<int>(first, last), context.c_str());
+
+        auto lower = lower_bound(root, lo), upper = upper_bound(root, lo);
+        auto modelLower = model.lower_bound(lo), modelUpper = model.upper_bound(lo);
+        CHECK_AT(collect(lower, endInorder(root)) == vector<int>(modelLower, model.end()), context.c_str());
+        CHECK_AT(collect(upper, endInorder(root)) == vector<int>(modelUpper, model.end()), context.c_str());
+        if (modelLower != model.begin()) {
+            CHECK_AT(lower != beginInorder(root) && *--lower == *prev(modelLower), context.c_str());
+        } else {
+            CHECK_AT(lower == beginInorder(root), context.c_str());
+        }
+        CHECK_AT((int)distance(lower_bound(root, lo), upper) == (int)distance(modelLower, modelUpper), context.c_str());
+    }
+}
+
+int main(int argc, char** argv) {
+    int steps = argc > 1 ? stoi(argv[1]) : 3000;
+    unsigned seed = argc > 2 ? (unsigned)stoul(argv[2]) : 42;
+    const int keyRange = 1000;
+    mt19937 rng(seed);
+
+    NodePool<bst::t_node> bstPool;
+    NodePool<avl::AVLNode> avlPool;
+    bst::t_node* bstRoot = nullptr;
+    avl::AVLNode* avlRoot = nullptr;
+    multiset<int> bstModel;
+    set<int> avlModel;
+
+    CHECK(bst::begin(bstRoot) == bst::end(bstRoot) && avl::begin(avlRoot) == avl::end(avlRoot));
+    CHECK(bst::range(bstRoot, INT_MIN, INT_MAX).begin() == bst::end(bstRoot));
+
+    for (int step = 0; step < steps; step++) {
+        int key = (int)(rng() % keyRange);
+        string what;
+        if (rng() % 100 < 65) {
+            bstRoot = bst::insertBST(bstRoot, key, &bstPool);
+            avlRoot = avl::insert(avlRoot, key, &avlPool);
+            bstModel.insert(key);
+            avlModel.insert(key);
+            what = "insert " + to_string(key);
+        } else {
+            bstRoot = bst::eraseBST(bstRoot, key, &bstPool);
+            avlRoot = avl::erase(avlRoot, key, &avlPool);
+            if (bstModel.count(key)) bstModel.erase(bstModel.find(key));
+            avlModel.erase(key);
+            what = "erase " + to_string(key);
+        }
+
+        string context = "step " + to_string(step) + " (" + what + ")";
+        checkIterators(bstRoot, bstModel, rng, "BST " + context);
+        checkIterators(avlRoot, avlModel, rng, "AVL " + context);
+
+        // The namespace wrappers are the core functions
+        CHECK_AT(bst::lower_bound(bstRoot, key) == core::lower_bound(bstRoot, key), context.c_str());
+        CHECK_AT(avl::upper_bound(avlRoot, key) == core::upper_bound(avlRoot, key), context.c_str());
+        if (test::failures()) break;
+    }
+    return test::testResult("iterator_test");
+}
@@ -0,0 +1,91 @@
+// parallelStats and parallelSearchNode against the serial walks.
+// Trees of several shapes, each large enough to be split: a complete tree, a random
+// BST, a right-leaning chain, a caterpillar (a chain with a large subtree hanging off
+// every node), the complete tree with stale cached sizes and with no sizes at all.
+// For every shape and spawn depth, each field of the statistics must equal
+// computeStats, and searches for present and missing keys must agree with a walk.
+//
+//   parallel_tree_test [threads] [seed]
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "test_util.h"
+#include "../src/binary_search_tree.h"
+#include "../src/node_pool.h"
+#include "../src/parallel_tree.h"
+
+using namespace std;
+
+// Node i gets children 2i+1 and 2i+2; keys are first..first+n-1
+template <typename N>
+static N* buildComplete(int n, int first, NodePool<N>& pool) {
+    vector<N*> nodes(n);
+    for (int i = 0; i < n; i++) nodes[i] = pool.create(first + i);
+    for (int i = 0; i < n; i++) {
+        if (2 * i + 1 < n) nodes[i]->left = nodes[2 * i + 1];
+        if (2 * i + 2 < n) nodes[i]->right = nodes[2 * i + 2];
+    }
+    return n ? nodes[0] : nullptr;
+}
+
+template <typename N>
+static void check(const char* shape, N* root, TaskPool& tasks, mt19937& rng) {
+    TreeStats expected = computeStats(root);
+    vector<int> keys;
+    core::forEachLevelOrder(root, [&](N* node) { keys.push_back(node->data); });
+
+    for (int spawnDepth : {0, 1, 4, 12, 40}) {
+        string context = string(shape) + ", spawn depth " + to_string(spawnDepth);
+        TreeStats stats = parallelStats(root, tasks, spawnDepth);
+        CHECK_AT(stats.height == expected.height && stats.size == expected.size, context.c_str());
+        CHECK_AT(stats.leaves == expected.leaves && stats.diameter == expected.diameter, context.c_str());
+        CHECK_AT(stats.balanced == expected.balanced && stats.depthCounts == expected.depthCounts, context.c_str());
+
+        CHECK_AT(!parallelSearchNode(root, -1, tasks, spawnDepth), context.c_str());
+        CHECK_AT(parallelSearchNode(root, keys.back(), tasks, spawnDepth), context.c_str());  // Deepest level
+        for (int i = 0; i < 5; i++) CHECK_AT(parallelSearchNode(root, keys[rng() % keys.size()], tasks, spawnDepth), context.c_str());
+    }
+}
+
+int main(int argc, char** argv) {
+    unsigned threads = argc > 1 ? (unsigned)stoul(argv[1]) : 4;
+    unsigned seed = argc > 2 ? (unsigned)stoul(argv[2]) : 42;
+    mt19937 rng(seed);
+    TaskPool tasks(threads);
+    NodePool<bst::t_node> pool;
+
+    bst::t_node* complete = buildComplete(300000, 0, pool);
+    check("complete, stale sizes", complete, tasks, rng);  // Every size is still 1
+    core::updateAugment(complete);
+    check("complete", complete, tasks, rng);
+
+    bst::t_node* random = nullptr;
+    for (int i = 0; i < 200000; i++) random = bst::insertBST(random, (int)(rng() % 1000000), &pool);
+    check("random BST", random, tasks, rng);
+
+    bst::t_node* chain = nullptr;
+    for (int i = 100000; i > 0; i--) {
+        bst::t_node* node = pool.create(i);
+        node->right = chain;
+        chain = node;
+    }
+    core::updateAugment(chain);
+    check("chain", chain, tasks, rng);
+
+    bst::t_node* caterpillar = nullptr;
+    for (int i = 60; i > 0; i--) {
+        bst::t_node* node = pool.create(i * 10000);
+        node->left = buildComplete(5000, i * 10000 + 1, pool);
+        node->right = caterpillar;
+        caterpillar = node;
+    }
+    core::updateAugment(caterpillar);
+    check("caterpillar", caterpillar, tasks, rng);
+
+    NodePool<core::Node<int>> plainPool;
+    check("complete, no sizes", buildComplete(300000, 0, plainPool), tasks, rng);
+
+    return test::testResult("parallel_tree_test");
+}
@@ -0,0 +1,62 @@
+// Random inserts and erases on a PersistentAVLTree while keeping snapshots.
+// After every step the current version must hold the model's keys with a height
+// within the AVL bound, and every retained snapshot must still hold the keys it had
+// when it was taken. Once all handles are gone no node may be left allocated.
+//
+//   persistent_avl_test [steps] [seed]
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "test_util.h"
+#include "../src/persistent_avl_tree.h"
+
+using namespace std;
+
+static vector<int> keysOf(const avl::PersistentAVLTree& tree) {
+    vector<int> keys;
+    tree.forEach([&](int key) { keys.push_back(key); });
+    return keys;
+}
+
+int main(int argc, char** argv) {
+    int steps = argc > 1 ? stoi(argv[1]) : 20000;
+    unsigned seed = argc > 2 ? (unsigned)stoul(argv[2]) : 42;
+    const int keyRange = 2000;
+
+    mt19937 rng(seed);
+    {
+        avl::PersistentAVLTree tree;
+        set<int> model;
+        vector<pair<avl::PersistentAVLTree, vector<int>>> snapshots;
+
+        for (int step = 0; step < steps; step++) {
+            int key = (int)(rng() % keyRange);
+            string context = "step " + to_string(step);
+            if (rng() % 100 < 55) {
+                tree.insert(key);
+                model.insert(key);
+            } else {
+                CHECK_AT(tree.erase(key) == (model.erase(key) == 1), context.c_str());
+            }
+
+            vector<int> expected(model.begin(), model.end());
+            CHECK_AT(keysOf(tree) == expected, context.c_str());
+            CHECK_AT(tree.size() == (int)model.size(), context.c_str());
+            CHECK_AT(tree.height() <= 1.4405 * log2(model.size() + 2.0), context.c_str());
+
+            if (step % 97 == 0) snapshots.push_back({tree.snapshot(), expected});
+            if (step % 1000 == 999) {
+                for (const auto& s : snapshots) CHECK_AT(keysOf(s.first) == s.second, context.c_str());
+                snapshots.erase(snapshots.begin(), snapshots.begin() + snapshots.size() / 2);  // Drop older versions
+            }
+            if (test::failures()) break;
+        }
+    }
+    CHECK(avl::PersistentAVLTree::liveNodes() == 0);
+    return test::testResult("persistent_avl_test");
+}
@@ -0,0 +1,111 @@
+// Redrawer against full repaints, with labels as long as a label gets (INT_MIN).
+// Each frame is recorded into a DisplayList and presented onto a Framebuffer, and
+// drawn again from scratch onto a second Framebuffer; after every present the two
+// must match pixel for pixel. Labels that differ only in their last character must
+// be damaged, and a frame presented twice must repaint nothing.
+//
+//   redraw_test [frames] [seed]
+
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "test_util.h"
+#include "../src/tree_redraw.h"
+#include "../src/tree_render.h"
+
+using namespace std;
+
+struct Label {
+    int x, y, key;
+};
+
+static const int width = 320, height = 120;
+static const uint32_t background = 0xFFFFFF;
+
+// Nodes and their keys, drawn the same way on any canvas
+template <typename Canvas>
+static void draw(Canvas& canvas, const vector<Label>& labels) {
+    for (const Label& l : labels) {
+        canvas.circle(l.x + 44, l.y + 5, 30, 0x000000);
+        canvas.text(l.x, l.y, to_string(l.key).c_str(), 0x0000FF);
+    }
+}
+
+static bool samePixels(const core::Framebuffer& a, const core::Framebuffer& b) {
+    for (int y = 0; y < height; y++)
+        for (int x = 0; x < width; x++)
+            if (a.pixel(x, y) != b.pixel(x, y)) return false;
+    return true;
+}
+
+int main(int argc, char** argv) {
+    int frames = argc > 1 ? stoi(argv[1]) : 500;
+    unsigned seed = argc > 2 ? (unsigned)stoul(argv[2]) : 42;
+    const int glyph = core::Framebuffer::glyphScale;
+
+    core::Framebuffer screen(width, height);
+    core::DisplayList frame(width, height, 4 * glyph, 5 * glyph);
+    core::Redrawer redrawer;
+
+    auto present = [&](const vector<Label>& labels, const char* context) {
+        frame.clear(background);
+        draw(frame, labels);
+        core::RedrawStats stats = redrawer.present(frame, screen);
+        core::Framebuffer expected(width, height);
+        expected.clear(background);
+        draw(expected, labels);
+        CHECK_AT(samePixels(screen, expected), context);
+        return stats;
+    };
+
+    // The recorded label keeps all eleven characters and is terminated
+    {
+        core::DisplayList list(width, height, 4 * glyph, 5 * glyph);
+        list.text(10, 10, "-2147483648", 0);
+        list.text(10, 10, "-2147483647", 0);
+        const core::DrawOp& a = list.items()[0];
+        const core::DrawOp& b = list.items()[1];
+        CHECK(strlen(a.text) == 11 && strcmp(a.text, "-2147483648") == 0);
+        CHECK(strlen(b.text) == 11 && strcmp(b.text, "-2147483647") == 0);
+        CHECK(a.c == 11 * 4 * glyph);
+        CHECK(b < a && !(a < b) && !(a < a));
+    }
+
+    // A one-character change at the end of the label
+    core::RedrawStats stats = present({{20, 40, INT_MIN}}, "first frame");
+    CHECK(stats.full);
+    stats = present({{20, 40, INT_MIN + 1}}, "INT_MIN to INT_MIN + 1");
+    CHECK(!stats.full && stats.rects == 1 && stats.pixels > 0);
+    stats = present({{20, 40, INT_MIN + 1}}, "same frame again");
+    CHECK(!stats.full && stats.rects == 0 && stats.pixels == 0);
+    stats = present({{20, 40, INT_MIN}, {200, 40, INT_MAX}}, "INT_MIN back, INT_MAX added");
+    CHECK(!stats.full && stats.rects == 2);
+
+    // Random frames of long and short labels moving on a coarse grid
+    mt19937 rng(seed);
+    const int extremes[] = {INT_MIN, INT_MIN + 1, INT_MAX, INT_MAX - 1, -1, 0};
+    vector<Label> labels;
+    for (int f = 0; f < frames; f++) {
+        int op = (int)(rng() % 4);
+        if (op == 0 || labels.empty()) {
+            int key = rng() % 2 ? extremes[rng() % 6] : (int)(rng() % 2000) - 1000;
+            labels.push_back({(int)(rng() % 24) * 10, (int)(rng() % 10) * 10, key});
+        } else if (op == 1) {
+            labels.erase(labels.begin() + rng() % labels.size());
+        } else if (op == 2) {
+            labels[rng() % labels.size()].key = extremes[rng() % 6];
+        } else {
+            Label& l = labels[rng() % labels.size()];
+            l.x = (int)(rng() % 24) * 10;
+        }
+        if (labels.size() > 4) labels.erase(labels.begin());
+        string context = "frame " + to_string(f);
+        present(labels, context.c_str());
+        if (test::failures()) break;
+    }
+    return test::testResult("redraw_test");
+}
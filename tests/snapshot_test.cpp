@@ -0,0 +1,128 @@
+// Snapshot round trips and rejection of corrupt files.
+// Saves and reloads empty, BST (with duplicate keys) and AVL trees, then edits single
+// records of a saved file and rewrites the checksum, so that only the shape checks
+// in SnapshotView::open can notice: a key out of order, a child subtree size that
+// does not match its parent's leftSize, a wrong height and an unbalanced AVL tree
+// must all be refused.
+
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "test_util.h"
+#include "../src/avl_tree.h"
+#include "../src/binary_search_tree.h"
+#include "../src/node_pool.h"
+
+using namespace std;
+
+static const string path = "snapshot_test.snap";
+
+static vector<char> readFile() {
+    vector<char> bytes;
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file) return bytes;
+    char chunk[4096];
+    size_t got;
+    while ((got = fread(chunk, 1, sizeof chunk, file)) > 0) bytes.insert(bytes.end(), chunk, chunk + got);
+    fclose(file);
+    return bytes;
+}
+
+// Apply edit to the records of the saved file and store a matching checksum
+static void corrupt(const vector<char>& original, function<void(SnapshotRecord*, uint64_t)> edit) {
+    vector<char> bytes = original;
+    SnapshotHeader* header = reinterpret_cast<SnapshotHeader*>(bytes.data());
+    SnapshotRecord* records = reinterpret_cast<SnapshotRecord*>(bytes.data() + sizeof(SnapshotHeader));
+    edit(records, header->count);
+    header->checksum = snapshotChecksum(records, header->count);
+    FILE* file = fopen(path.c_str(), "wb");
+    fwrite(bytes.data(), 1, bytes.size(), file);
+    fclose(file);
+}
+
+static bool opens(SnapshotKind kind) {
+    SnapshotView view;
+    return view.open(path, kind);
+}
+
+int main() {
+    // Empty tree: just the header
+    {
+        CHECK(saveSnapshot(path, (avl::AVLNode*)nullptr, SNAPSHOT_AVL));
+        SnapshotView view;
+        CHECK_AT(view.open(path, SNAPSHOT_AVL), view.error().c_str());
+        CHECK(view.size() == 0);
+        CHECK(avl::loadAVL(view) == nullptr);
+    }
+
+    mt19937 rng(42);
+
+    // BST with duplicates (they go right) round trips with its shape
+    {
+        NodePool<bst::t_node> pool;
+        bst::t_node* root = nullptr;
+        vector<int> keys;
+        for (int i = 0; i < 500; i++) keys.push_back((int)(rng() % 100));
+        for (int k : keys) root = bst::insertBST(root, k, &pool);
+        CHECK(bst::saveBST(path, root));
+        SnapshotView view;
+        CHECK_AT(view.open(path, SNAPSHOT_BST), view.error().c_str());
+        bst::t_node* copy = bst::loadBST(view, &pool);
+        vector<int> a, b;
+        core::forEachPreorder(root, [&](bst::t_node* n) { a.push_back(n->data); });
+        core::forEachPreorder(copy, [&](bst::t_node* n) { b.push_back(n->data); });
+        CHECK(a == b);
+        CHECK(bst::countNodes(copy) == 500);
+    }
+
+    // AVL round trip, then corrupted copies of the file
+    NodePool<avl::AVLNode> pool;
+    avl::AVLNode* root = nullptr;
+    for (int i = 0; i < 1000; i++) root = avl::insert(root, (int)(rng() % 100000), &pool);
+    CHECK(avl::saveAVL(path, root));
+    {
+        SnapshotView view;
+        CHECK_AT(view.open(path, SNAPSHOT_AVL), view.error().c_str());
+        CHECK(avl::checkInvariants(avl::loadAVL(view, &pool)));
+    }
+    vector<char> saved = readFile();
+
+    // Two keys swapped: the checksum matches, the order does not
+    corrupt(saved, [](SnapshotRecord* r, uint64_t n) { swap(r[1].data, r[n - 1].data); });
+    CHECK(!opens(SNAPSHOT_AVL));
+
+    // The root's leftSize moves one node from the left subtree to the right one
+    corrupt(saved, [](SnapshotRecord* r, uint64_t) { r[0].leftSize--; });
+    CHECK(!opens(SNAPSHOT_AVL));
+
+    // A leaf claims height 2
+    corrupt(saved, [](SnapshotRecord* r, uint64_t n) {
+        for (uint64_t i = 0; i < n; i++)
+            if (r[i].size == 1) {
+                r[i].height = 2;
+                break;
+            }
+    });
+    CHECK(!opens(SNAPSHOT_AVL));
+
+    // A right-leaning chain with consistent sizes and heights is a valid BST but not an AVL tree
+    {
+        NodePool<bst::t_node> chainPool;
+        bst::t_node* chain = nullptr;
+        for (int k = 0; k < 10; k++) chain = bst::insertBST(chain, k, &chainPool);
+        CHECK(saveSnapshot(path, chain, SNAPSHOT_AVL));
+        CHECK(!opens(SNAPSHOT_AVL));
+        CHECK(bst::saveBST(path, chain));
+        CHECK(opens(SNAPSHOT_BST));
+    }
+
+    // The unmodified file still opens
+    corrupt(saved, [](SnapshotRecord*, uint64_t) {});
+    CHECK(opens(SNAPSHOT_AVL));
+
+    remove(path.c_str());
+    return test::testResult("snapshot_test");
+}
@@ -0,0 +1,38 @@
+#ifndef TEST_UTIL_H
+#define TEST_UTIL_H
+
+// Minimal checks for the test drivers: CHECK reports the failing expression and
+// keeps going, testResult() is the process exit code. The tests are built without
+// NDEBUG (see CMakeLists.txt), so the asserts inside the tree headers stay on too.
+
+#include <cstdio>
+
+#ifdef NDEBUG
+#error "tests must be built without NDEBUG"
+#endif
+
+namespace test {
+
+inline int& failures() {
+    static int count = 0;
+    return count;
+}
+
+inline bool check(bool ok, const char* expr, const char* file, int line, const char* context) {
+    if (!ok && ++failures() <= 20) std::fprintf(stderr, "%s:%d: CHECK(%s) failed%s%s\n", file, line, expr,
+                                                context[0] ? " at " : "", context);
+    return ok;
+}
+
+inline int testResult(const char* name) {
+    if (failures()) std::fprintf(stderr, "%s: %d checks failed\n", name, failures());
+    else std::printf("%s: ok\n", name);
+    return failures() ? 1 : 0;
+}
+
+}  // namespace test
+
+#define CHECK(expr) test::check((expr), #expr, __FILE__, __LINE__, "")
+#define CHECK_AT(expr, context) test::check((expr), #expr, __FILE__, __LINE__, (context))
+
+#endif
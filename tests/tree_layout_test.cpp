@@ -0,0 +1,95 @@
+// Incremental layout against a fresh build.
+// Keys are inserted into a BST (duplicates kept) and an AVL tree (duplicates ignored,
+// rotations on ascending and descending runs) and each layout is updated with
+// inserted(); after every insert it must equal TreeLayout::build of the same tree,
+// slot for slot, and every child's column from leftColumn / rightColumn must be the
+// column the child actually has. Also checked: a layout that fell behind the tree is
+// rebuilt by the next inserted(), and a layout rebuilt after erases (as the
+// visualizers do) goes on updating correctly.
+//
+//   tree_layout_test [steps] [seed]
+
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "test_util.h"
+#include "../src/avl_tree.h"
+#include "../src/binary_search_tree.h"
+#include "../src/node_pool.h"
+#include "../src/tree_layout.h"
+
+using namespace std;
+
+template <typename N>
+static bool sameLayout(const core::TreeLayout<N>& layout, N* root) {
+    core::TreeLayout<N> fresh;
+    fresh.build(root);
+    if (layout.size() != fresh.size() || layout.size() != core::getSize(root)) return false;
+    unordered_map<N*, int> columns;
+    for (int column = 0; column < fresh.size(); column++) {
+        const auto& a = layout.slot(column);
+        const auto& b = fresh.slot(column);
+        if (a.node != b.node || a.depth != b.depth) return false;
+        columns[b.node] = column;
+    }
+    for (int column = 0; column < layout.size(); column++) {
+        N* node = layout.slot(column).node;
+        if (node->left && layout.leftColumn(column) != columns[node->left]) return false;
+        if (node->right && layout.rightColumn(column) != columns[node->right]) return false;
+    }
+    return !root || layout.rootColumn(root) == columns[root];
+}
+
+int main(int argc, char** argv) {
+    int steps = argc > 1 ? stoi(argv[1]) : 3000;
+    unsigned seed = argc > 2 ? (unsigned)stoul(argv[2]) : 42;
+    mt19937 rng(seed);
+
+    NodePool<bst::t_node> bstPool;
+    NodePool<avl::AVLNode> avlPool;
+    bst::t_node* bstRoot = nullptr;
+    avl::AVLNode* avlRoot = nullptr;
+    core::TreeLayout<bst::t_node> bstLayout;
+    core::TreeLayout<avl::AVLNode> avlLayout;
+    int run = 0;
+
+    for (int step = 0; step < steps; step++) {
+        int op = (int)(rng() % 100), key;
+        if (op < 60) key = (int)(rng() % 2000);
+        else if (op < 80) key = 5000 + run++;  // Ascending: single rotations at the right edge
+        else key = -run++;
+
+        string context = "step " + to_string(step) + " (insert " + to_string(key) + ")";
+        bstRoot = bst::insertBST(bstRoot, key, &bstPool);
+        avlRoot = avl::insert(avlRoot, key, &avlPool);
+        bstLayout.inserted(bstRoot, key);
+        avlLayout.inserted(avlRoot, key);
+        CHECK_AT(sameLayout(bstLayout, bstRoot), ("BST " + context).c_str());
+        CHECK_AT(sameLayout(avlLayout, avlRoot), ("AVL " + context).c_str());
+
+        if (step % 500 == 250) {
+            // Two inserts before one update: the layout is rebuilt
+            bstRoot = bst::insertBST(bstRoot, key, &bstPool);
+            bstRoot = bst::insertBST(bstRoot, key + 1, &bstPool);
+            avlRoot = avl::insert(avlRoot, 100000 + step, &avlPool);
+            avlRoot = avl::insert(avlRoot, 100001 + step, &avlPool);
+            bstLayout.inserted(bstRoot, key + 1);
+            avlLayout.inserted(avlRoot, 100001 + step);
+            CHECK_AT(sameLayout(bstLayout, bstRoot), ("BST catching up, " + context).c_str());
+            CHECK_AT(sameLayout(avlLayout, avlRoot), ("AVL catching up, " + context).c_str());
+        } else if (step % 500 == 499) {
+            // Erases, then a full build as the visualizers do when the counts differ
+            for (int i = 0; i < 20; i++) {
+                int erased = (int)(rng() % 2000);
+                bstRoot = bst::eraseBST(bstRoot, erased, &bstPool);
+                avlRoot = avl::erase(avlRoot, erased, &avlPool);
+            }
+            bstLayout.build(bstRoot);
+            avlLayout.build(avlRoot);
+        }
+        if (test::failures()) break;
+    }
+    return test::testResult("tree_layout_test");
+}
@@ -0,0 +1,134 @@
+// bst::TreeMap and avl::TreeMap against a std::map.
+// Random upsert / try_emplace / emplace / operator[] / find / contains on int keys,
+// with the (key, value) pairs, size and cached subtree sizes (and in the AVL map the
+// cached heights and balance) checked after every step. Then std::string keys with
+// move-only values: lookups by std::string_view and const char* under the default
+// transparent comparator and under std::less<std::string>, and try_emplace leaving
+// its arguments alone when the key is present.
+//
+//   tree_map_test [steps] [seed]
+
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "test_util.h"
+#include "../src/tree_map.h"
+
+using namespace std;
+
+// Cached sizes, and with heights cached, heights and AVL balance; returns the subtree size
+template <typename Node>
+static int checkShape(const Node* node, int& height, bool& ok) {
+    if (!node) {
+        height = 0;
+        return 0;
+    }
+    int leftHeight, rightHeight;
+    int size = 1 + checkShape(node->left, leftHeight, ok) + checkShape(node->right, rightHeight, ok);
+    height = 1 + max(leftHeight, rightHeight);
+    ok = ok && node->size == size;
+    if constexpr (Node::augment_type::tracksHeight) ok = ok && node->height == height && abs(leftHeight - rightHeight) <= 1;
+    return size;
+}
+
+template <typename Map>
+static void runInts(const char* name, int steps, mt19937& rng) {
+    const int keyRange = 2000;
+    Map map;
+    std::map<int, long long> model;
+
+    for (int step = 0; step < steps; step++) {
+        int key = (int)(rng() % keyRange), op = (int)(rng() % 6);
+        long long value = (long long)rng();
+        string context = string(name) + " step " + to_string(step);
+        if (op == 0) {
+            bool inserted = model.find(key) == model.end();
+            model[key] = value;
+            CHECK_AT(map.upsert(key, value) == inserted, context.c_str());
+        } else if (op == 1) {
+            auto expected = model.try_emplace(key, value);
+            auto result = map.try_emplace(key, value);
+            CHECK_AT(result.second == expected.second && result.first->data == key, context.c_str());
+            CHECK_AT(result.first->value == expected.first->second, context.c_str());
+        } else if (op == 2) {
+            auto expected = model.emplace(key, value);
+            auto result = map.emplace(key, value);
+            CHECK_AT(result.second == expected.second && result.first->value == expected.first->second, context.c_str());
+        } else if (op == 3) {
+            map[key] += value;
+            model[key] += value;
+        } else {
+            auto it = model.find(key);
+            long long* found = map.find(key);
+            CHECK_AT(it == model.end() ? !found : found && *found == it->second, context.c_str());
+            CHECK_AT(map.contains(key) == (it != model.end()), context.c_str());
+        }
+
+        vector<pair<int, long long>> pairs, expected(model.begin(), model.end());
+        map.forEach([&](int k, long long v) { pairs.push_back({k, v}); });
+        CHECK_AT(pairs == expected, context.c_str());
+        CHECK_AT(map.size() == (int)model.size(), context.c_str());
+        int height;
+        bool ok = true;
+        checkShape(map.getRoot(), height, ok);
+        CHECK_AT(ok && map.height() == height, context.c_str());
+        if (test::failures()) return;
+    }
+}
+
+template <typename Map>
+static void runStrings(const char* name) {
+    Map map;
+    vector<string> words = {"pear", "apple", "fig", "", "banana", "kiwi", "apple pie", "date", "cherry", "b"};
+    for (size_t i = 0; i < words.size(); i++) {
+        string_view word = words[i];
+        auto result = map.try_emplace(word, make_unique<int>((int)i));  // The string is built from the view
+        CHECK_AT(result.second && result.first->data == words[i], name);
+    }
+    CHECK_AT(map.size() == (int)words.size(), name);
+
+    for (size_t i = 0; i < words.size(); i++) {
+        const unique_ptr<int>* byView = map.find(string_view(words[i]));
+        const unique_ptr<int>* byPointer = map.find(words[i].c_str());
+        CHECK_AT(byView && **byView == (int)i && byPointer == byView, name);
+    }
+    CHECK_AT(!map.contains(string_view("apples")) && !map.contains("appl") && !map.contains(string("c")), name);
+
+    // A present key: the value argument must not be moved from
+    unique_ptr<int> spare = make_unique<int>(99);
+    auto result = map.try_emplace(string_view("fig"), std::move(spare));
+    CHECK_AT(!result.second && spare && *spare == 99 && *result.first->value == 2, name);
+
+    CHECK_AT(!map.upsert(string("fig"), make_unique<int>(7)) && **map.find("fig") == 7, name);
+    CHECK_AT(map.upsert(string_view("grape"), make_unique<int>(8)) && **map.find(string_view("grape")) == 8, name);
+    CHECK_AT(!map.emplace("kiwi", make_unique<int>(0)).second && **map.find("kiwi") == 5, name);
+
+    vector<string> keys;
+    map.forEach([&](const string& k, const unique_ptr<int>&) { keys.push_back(k); });
+    std::map<string, int> sorted;
+    for (const string& w : words) sorted[w];
+    sorted["grape"];
+    vector<string> expected;
+    for (const auto& entry : sorted) expected.push_back(entry.first);
+    CHECK_AT(keys == expected, name);
+}
+
+int main(int argc, char** argv) {
+    int steps = argc > 1 ? stoi(argv[1]) : 20000;
+    unsigned seed = argc > 2 ? (unsigned)stoul(argv[2]) : 42;
+    mt19937 rng(seed);
+
+    runInts<bst::TreeMap<int, long long>>("bst int map", steps, rng);
+    runInts<avl::TreeMap<int, long long>>("avl int map", steps, rng);
+    runStrings<bst::TreeMap<string, unique_ptr<int>>>("bst string map");
+    runStrings<avl::TreeMap<string, unique_ptr<int>>>("avl string map");
+    runStrings<avl::TreeMap<string, unique_ptr<int>, less<string>>>("avl string map, std::less<std::string>");
+
+    return test::testResult("tree_map_test");
+}